@@ -0,0 +1,70 @@
+#include "adaptive_delay.h"
+
+#include <assert.h>
+
+// The target delay (when no frame is late) is a multiple of the jitter
+#define SC_ADAPTIVE_DELAY_JITTER_FACTOR 4
+
+// Smoothing of the jitter estimation (as in RFC 3550)
+#define SC_ADAPTIVE_DELAY_JITTER_SMOOTHING 16
+
+// Do not decrease the target delay for some time after a late frame
+#define SC_ADAPTIVE_DELAY_HOLD SC_TICK_FROM_SEC(5)
+
+// Interval between two decreasing steps (each step removes 1/4 of the excess)
+#define SC_ADAPTIVE_DELAY_STEP_INTERVAL SC_TICK_FROM_SEC(1)
+
+void
+sc_adaptive_delay_init(struct sc_adaptive_delay *ad, sc_tick min,
+                       sc_tick max) {
+    assert(min <= max);
+
+    ad->min = min;
+    ad->max = max;
+    ad->target = min;
+    ad->jitter = 0;
+    ad->has_transit = false;
+    ad->transit = 0;
+    ad->next_decrease = 0;
+}
+
+bool
+sc_adaptive_delay_on_arrival(struct sc_adaptive_delay *ad, sc_tick system,
+                             sc_tick stream) {
+    sc_tick transit = system - stream;
+    if (ad->has_transit) {
+        sc_tick d = transit - ad->transit;
+        if (d < 0) {
+            d = -d;
+        }
+        ad->jitter += (d - ad->jitter) / SC_ADAPTIVE_DELAY_JITTER_SMOOTHING;
+    }
+    ad->transit = transit;
+    ad->has_transit = true;
+
+    sc_tick desired = SC_ADAPTIVE_DELAY_JITTER_FACTOR * ad->jitter;
+    desired = CLAMP(desired, ad->min, ad->max);
+
+    sc_tick old_target = ad->target;
+    if (desired > ad->target) {
+        ad->target = desired;
+    } else if (desired < ad->target && system >= ad->next_decrease) {
+        // Round up so that the target eventually reaches the desired value
+        ad->target -= (ad->target - desired + 3) / 4;
+        ad->next_decrease = system + SC_ADAPTIVE_DELAY_STEP_INTERVAL;
+    }
+
+    return ad->target != old_target;
+}
+
+bool
+sc_adaptive_delay_on_late(struct sc_adaptive_delay *ad, sc_tick now,
+                          sc_tick lateness) {
+    assert(lateness >= 0);
+
+    sc_tick old_target = ad->target;
+    ad->target = MIN(ad->target + lateness + ad->jitter, ad->max);
+    ad->next_decrease = now + SC_ADAPTIVE_DELAY_HOLD;
+
+    return ad->target != old_target;
+}
@@ -0,0 +1,56 @@
+#ifndef SC_ADAPTIVE_DELAY_H
+#define SC_ADAPTIVE_DELAY_H
+
+#include "common.h"
+
+#include <stdbool.h>
+
+#include "util/tick.h"
+
+/**
+ * Adapt the buffering delay to the jitter of the stream.
+ *
+ * The jitter is estimated from the same points as the clock (system time of
+ * arrival, stream time), as the smoothed mean deviation of the transit time
+ * (like the interarrival jitter of RFC 3550).
+ *
+ * The target delay grows immediately when a frame is late (or when the
+ * jitter increases), and shrinks slowly towards a few times the jitter once
+ * no frame has been late for a while. It is always kept between min and max.
+ */
+struct sc_adaptive_delay {
+    sc_tick min;
+    sc_tick max;
+
+    sc_tick target;
+    sc_tick jitter;
+
+    bool has_transit;
+    sc_tick transit; // last transit time (system - stream)
+
+    // The target may not decrease before this date
+    sc_tick next_decrease;
+};
+
+void
+sc_adaptive_delay_init(struct sc_adaptive_delay *ad, sc_tick min, sc_tick max);
+
+/**
+ * Update the jitter estimation on frame arrival
+ *
+ * Return true if the target delay changed.
+ */
+bool
+sc_adaptive_delay_on_arrival(struct sc_adaptive_delay *ad, sc_tick system,
+                             sc_tick stream);
+
+/**
+ * Increase the target delay when a frame was late by the given duration
+ *
+ * Return true if the target delay changed.
+ */
+bool
+sc_adaptive_delay_on_late(struct sc_adaptive_delay *ad, sc_tick now,
+                          sc_tick lateness);
+
+#endif
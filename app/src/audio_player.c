@@ -3,6 +3,7 @@
 #include <libavcodec/avcodec.h>
 #include <libavutil/opt.h>
 
+#include "util/audioconv.h"
 #include "util/log.h"
 
 #define SC_AUDIO_PLAYER_NDEBUG // comment to debug
@@ -36,6 +37,9 @@
  * configured using swr_set_compensation(). An important work for the player
  * is to estimate the compensation value regularly and apply it.
  *
+ * While no compensation is applied, libswresample is bypassed: the decoded
+ * samples are converted (interleaved) directly to the audio buffer.
+ *
  * The estimated buffering level is the result of averaging the "natural"
  * buffering (samples are produced and consumed by blocks, so it must be
  * smoothed), and making instant adjustments resulting of its own actions
@@ -51,6 +55,12 @@
  *
  * Therefore, the player doesn't drop any sample on underflow. The compensation
  * mechanism will absorb the delay introduced by the inserted silence.
+ *
+ * The receiver thread (producer) and the SDL audio callback (consumer) never
+ * lock each other: the audio buffer is a single-producer single-consumer ring
+ * buffer, and the few values they share (underflow, samples to skip, started
+ * flags) are atomic. The producer never moves the read cursor: when too many
+ * samples are buffered, it requests the consumer to drop them.
  */
 
 /** Downcast frame_sink to sc_audio_player */
@@ -61,13 +71,52 @@
 
 #define TO_BYTES(SAMPLES) sc_audiobuf_to_bytes(&ap->buf, (SAMPLES))
 #define TO_SAMPLES(BYTES) sc_audiobuf_to_samples(&ap->buf, (BYTES))
+#define TICK_TO_SAMPLES(TICK) ((TICK) * ap->sample_rate / SC_TICK_FREQ)
+#define SAMPLES_TO_MS(SAMPLES) ((SAMPLES) * 1000 / ap->sample_rate)
+
+struct sc_audio_player_profile {
+    // Interval between two compensation updates
+    sc_tick resync_interval;
+    // Duration over which a compensation value is applied
+    sc_tick compensation_distance;
+    // Maximum compensation rate, in percent
+    unsigned max_compensation_percent;
+    // Part of the initial buffering left to compensation instead of silence
+    sc_tick start_margin;
+    // Number of consecutive compensation updates with the buffering too high
+    // before dropping old samples (0 to only rely on resampling)
+    unsigned overflow_resyncs;
+    // Interval between two latency reports (0 to disable)
+    sc_tick report_interval;
+};
+
+static const struct sc_audio_player_profile sc_audio_player_profile_default = {
+    .resync_interval = SC_TICK_FROM_SEC(1),
+    .compensation_distance = SC_TICK_FROM_SEC(4),
+    .max_compensation_percent = 2,
+    .start_margin = SC_TICK_FROM_MS(30),
+    .overflow_resyncs = 0,
+    .report_interval = 0,
+};
+
+// For --audio-low-latency: react faster and more strongly to drift, and drop
+// old samples rather than waiting for resampling to absorb a large excess
+static const struct sc_audio_player_profile
+sc_audio_player_profile_low_latency = {
+    .resync_interval = SC_TICK_FROM_MS(250),
+    .compensation_distance = SC_TICK_FROM_SEC(1),
+    .max_compensation_percent = 5,
+    .start_margin = SC_TICK_FROM_MS(10),
+    .overflow_resyncs = 4, // 1 second
+    .report_interval = SC_TICK_FROM_SEC(5),
+};
 
 static void SDLCALL
 sc_audio_player_sdl_callback(void *userdata, uint8_t *stream, int len_int) {
     struct sc_audio_player *ap = userdata;
 
-    // This callback is called with the lock used by SDL_AudioDeviceLock(), so
-    // the audiobuf is protected
+    // This callback runs without any lock: it is the only consumer of the
+    // audiobuf, and only exchanges atomic values with the receiver thread
 
     assert(len_int > 0);
     size_t len = len_int;
@@ -77,12 +126,21 @@ sc_audio_player_sdl_callback(void *userdata, uint8_t *stream, int len_int) {
     LOGD("[Audio] SDL callback requests %" PRIu32 " samples", count);
 #endif
 
-    uint32_t buffered_samples = sc_audiobuf_can_read(&ap->buf);
-    if (!ap->played) {
+    // Old samples may only be dropped by the consumer, the receiver thread
+    // requests it (see sc_audio_player_frame_sink_push()), unless it holds the
+    // audio device lock (see sc_audio_player_make_room())
+    uint32_t skip = atomic_exchange_explicit(&ap->skip_request, 0,
+                                             memory_order_relaxed);
+    if (skip) {
+        sc_audiobuf_skip(&ap->buf, skip);
+    }
+
+    bool played = atomic_load_explicit(&ap->played, memory_order_relaxed);
+    if (!played) {
+        uint32_t buffered_samples = sc_audiobuf_can_read(&ap->buf);
         // Part of the buffering is handled by inserting initial silence. The
         // remaining (margin) last samples will be handled by compensation.
-        uint32_t margin = 30 * ap->sample_rate / 1000; // 30ms
-        if (buffered_samples + margin < ap->target_buffering) {
+        if (buffered_samples + ap->start_margin < ap->target_buffering) {
             LOGV("[Audio] Inserting initial buffering silence: %" PRIu32
                  " samples", count);
             // Delay playback starting to reach the target buffering. Fill the
@@ -93,10 +151,7 @@ sc_audio_player_sdl_callback(void *userdata, uint8_t *stream, int len_int) {
         }
     }
 
-    uint32_t read = MIN(buffered_samples, count);
-    if (read) {
-        sc_audiobuf_read(&ap->buf, stream, read);
-    }
+    uint32_t read = sc_audiobuf_read(&ap->buf, stream, count);
 
     if (read < count) {
         uint32_t silence = count - read;
@@ -109,13 +164,18 @@ sc_audio_player_sdl_callback(void *userdata, uint8_t *stream, int len_int) {
              silence);
         memset(stream + TO_BYTES(read), 0, TO_BYTES(silence));
 
-        if (ap->received) {
+        bool received =
+            atomic_load_explicit(&ap->received, memory_order_relaxed);
+        if (received) {
             // Inserting additional samples immediately increases buffering
-            ap->underflow += silence;
+            atomic_fetch_add_explicit(&ap->underflow, silence,
+                                      memory_order_relaxed);
+            atomic_fetch_add_explicit(&ap->underflow_count, 1,
+                                      memory_order_relaxed);
         }
     }
 
-    ap->played = true;
+    atomic_store_explicit(&ap->played, true, memory_order_relaxed);
 }
 
 static uint8_t *
@@ -136,109 +196,279 @@ sc_audio_player_get_swr_buf(struct sc_audio_player *ap, uint32_t min_samples) {
     return ap->swr_buf;
 }
 
+// Make room for the next samples_count samples, by dropping the oldest
+// buffered samples if the audio buffer is full, so that the new samples are
+// never truncated. Return the number of samples dropped.
+static uint32_t
+sc_audio_player_make_room(struct sc_audio_player *ap, uint32_t samples_count) {
+    if (sc_audiobuf_can_write(&ap->buf) >= samples_count) {
+        // Fast path, without locking
+        return 0;
+    }
+
+    // Only the consumer may drop samples: prevent the SDL callback from
+    // running meanwhile. This is very unlikely (the audio buffer is allocated
+    // with a size sufficient to store 1 second more than the target
+    // buffering).
+    SDL_LockAudioDevice(ap->device);
+
+    // Apply the pending skip request now, otherwise the callback would drop
+    // the new samples once they are written
+    uint32_t skip = atomic_exchange_explicit(&ap->skip_request, 0,
+                                             memory_order_relaxed);
+    if (skip) {
+        sc_audiobuf_skip(&ap->buf, skip);
+    }
+
+    uint32_t dropped = sc_audiobuf_make_room(&ap->buf, samples_count);
+
+    SDL_UnlockAudioDevice(ap->device);
+
+    return dropped;
+}
+
 static bool
-sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
-                                const AVFrame *frame) {
-    struct sc_audio_player *ap = DOWNCAST(sink);
+sc_audio_player_can_write_direct(const AVFrame *frame) {
+    // Formats output by the decoders of the supported codecs (FLTP for Opus
+    // and AAC, S16 for FLAC and raw) which can be converted without
+    // libswresample
+    return frame->format == AV_SAMPLE_FMT_FLTP
+        || frame->format == AV_SAMPLE_FMT_FLT
+        || frame->format == AV_SAMPLE_FMT_S16;
+}
 
-    SwrContext *swr_ctx = ap->swr_ctx;
+static uint32_t
+sc_audio_player_write_direct(struct sc_audio_player *ap,
+                             const AVFrame *frame, uint32_t *dropped) {
+    assert(frame->nb_samples >= 0);
+    uint32_t samples = frame->nb_samples;
 
-    int64_t swr_delay = swr_get_delay(swr_ctx, ap->sample_rate);
-    // No need to av_rescale_rnd(), input and output sample rates are the same.
-    // Add more space (256) for clock compensation.
-    int dst_nb_samples = swr_delay + frame->nb_samples + 256;
+    *dropped += sc_audio_player_make_room(ap, samples);
 
+    if (frame->format == AV_SAMPLE_FMT_FLT) {
+        // Already in the output format
+        return sc_audiobuf_write(&ap->buf, frame->data[0], samples);
+    }
+
+    // The free space may be split in two parts around the end of the buffer
+    uint32_t written = 0;
+    while (written < samples) {
+        void *area;
+        uint32_t count = sc_audiobuf_write_area(&ap->buf, &area);
+        if (!count) {
+            // The buffer is full
+            break;
+        }
+        count = MIN(count, samples - written);
+
+        if (frame->format == AV_SAMPLE_FMT_FLTP) {
+            const float *const *src =
+                (const float *const *) frame->extended_data;
+            sc_audioconv_interleave_f32(area, src, ap->nb_channels, written,
+                                        count);
+        } else {
+            assert(frame->format == AV_SAMPLE_FMT_S16);
+            const int16_t *src = (const int16_t *) frame->data[0];
+            sc_audioconv_s16_to_f32(area, src, ap->nb_channels, written,
+                                    count);
+        }
+
+        sc_audiobuf_commit_write(&ap->buf, count);
+        written += count;
+    }
+
+    return written;
+}
+
+static int
+sc_audio_player_flush_swr(struct sc_audio_player *ap, uint32_t *written,
+                          uint32_t *dropped) {
+    *written = 0;
+
+    int64_t swr_delay = swr_get_delay(ap->swr_ctx, ap->sample_rate);
+    if (!swr_delay) {
+        return 0;
+    }
+
+    // Since the last compensation, some samples are still delayed in the
+    // resampler: output them before switching to the direct conversion
+    int dst_nb_samples = swr_delay + 256;
     uint8_t *swr_buf = sc_audio_player_get_swr_buf(ap, dst_nb_samples);
     if (!swr_buf) {
-        return false;
+        return -1;
     }
 
-    int ret = swr_convert(swr_ctx, &swr_buf, dst_nb_samples,
-                          (const uint8_t **) frame->data, frame->nb_samples);
+    int ret = swr_convert(ap->swr_ctx, &swr_buf, dst_nb_samples, NULL, 0);
     if (ret < 0) {
         LOGE("Resampling failed: %d", ret);
-        return false;
+        return -1;
     }
+    uint32_t flushed = MIN(ret, dst_nb_samples);
 
-    // swr_convert() returns the number of samples which would have been
-    // written if the buffer was big enough.
-    uint32_t samples_written = MIN(ret, dst_nb_samples);
-#ifndef SC_AUDIO_PLAYER_NDEBUG
-    LOGD("[Audio] %" PRIu32 " samples written to buffer", samples_written);
-#endif
+    // Reset the resampler after flushing, for the next compensation
+    ret = swr_init(ap->swr_ctx);
+    if (ret) {
+        LOGE("Failed to initialize the resampling context");
+        return -1;
+    }
+
+    *dropped += sc_audio_player_make_room(ap, flushed);
+    *written = sc_audiobuf_write(&ap->buf, swr_buf, flushed);
+    return flushed;
+}
 
-    // Since this function is the only writer, the current available space is
-    // at least the previous available space. In practice, it should almost
-    // always be possible to write without lock.
-    bool lockless_write = samples_written <= ap->previous_can_write;
-    if (lockless_write) {
-        sc_audiobuf_prepare_write(&ap->buf, swr_buf, samples_written);
+static void
+sc_audio_player_check_overflow(struct sc_audio_player *ap, float avg,
+                               uint32_t buffered_samples) {
+    // Resampling alone takes a while to absorb a large excess of buffering
+    // (for example after a network burst). If the buffering stays too high
+    // for some time, drop old samples to restore the target immediately.
+    uint32_t threshold = ap->target_buffering + ap->target_buffering / 2;
+    if (avg <= threshold || buffered_samples <= ap->target_buffering) {
+        ap->overflow_resyncs = 0;
+        return;
     }
 
-    SDL_LockAudioDevice(ap->device);
+    if (++ap->overflow_resyncs < ap->profile->overflow_resyncs) {
+        return;
+    }
 
-    uint32_t buffered_samples = sc_audiobuf_can_read(&ap->buf);
+    uint32_t skip_samples = buffered_samples - ap->target_buffering;
+    // Replace any pending request, this one drops more samples
+    atomic_store_explicit(&ap->skip_request, skip_samples,
+                          memory_order_relaxed);
+    // Dropping samples instantly decreases buffering
+    ap->avg_buffering.avg -= skip_samples;
+    ap->overflow_resyncs = 0;
+    LOGD("[Audio] Sustained buffering overflow, skipping %" PRIu32 " samples",
+         skip_samples);
+}
 
-    if (lockless_write) {
-        sc_audiobuf_commit_write(&ap->buf, samples_written);
-    } else {
-        uint32_t can_write = sc_audiobuf_can_write(&ap->buf);
-        if (samples_written > can_write) {
-            // Entering this branch is very unlikely, the audio buffer is
-            // allocated with a size sufficient to store 1 second more than the
-            // target buffering. If this happens, though, we have to skip old
-            // samples.
-            uint32_t cap = sc_audiobuf_capacity(&ap->buf);
-            if (samples_written > cap) {
-                // Very very unlikely: a single resampled frame should never
-                // exceed the audio buffer size (or something is very wrong).
-                // Ignore the first bytes in swr_buf
-                swr_buf += TO_BYTES(samples_written - cap);
-                // This change in samples_written will impact the
-                // instant_compensation below
-                samples_written = cap;
-            }
+static void
+sc_audio_player_report(struct sc_audio_player *ap, uint32_t buffered_samples,
+                       uint32_t underflow, uint32_t samples_written) {
+    struct sc_audio_player_stats *stats = &ap->stats;
+
+    stats->buffered_sum += buffered_samples;
+    stats->buffered_max = MAX(stats->buffered_max, buffered_samples);
+    ++stats->pushes;
+    stats->silence += underflow;
+    stats->samples += samples_written;
+
+    if (stats->samples < ap->report_samples) {
+        return;
+    }
 
-            assert(samples_written >= can_write);
-            if (samples_written > can_write) {
-                uint32_t skip_samples = samples_written - can_write;
-                assert(buffered_samples >= skip_samples);
-                sc_audiobuf_skip(&ap->buf, skip_samples);
-                buffered_samples -= skip_samples;
-                if (ap->played) {
-                    // Dropping input samples instantly decreases buffering
-                    ap->avg_buffering.avg -= skip_samples;
-                }
-            }
+    uint32_t underflows = atomic_exchange_explicit(&ap->underflow_count, 0,
+                                                   memory_order_relaxed);
+    uint32_t avg = stats->buffered_sum / stats->pushes;
+
+    // The latency added by the player is the buffering plus the SDL output
+    // buffer
+    LOGI("Audio latency: %" PRIu32 " ms (max %" PRIu32 " ms, target %" PRIu32
+         " ms), %" PRIu32 " underflows (%" PRIu32 " ms of silence)",
+         SAMPLES_TO_MS(avg + ap->output_buffer),
+         SAMPLES_TO_MS(stats->buffered_max + ap->output_buffer),
+         SAMPLES_TO_MS(ap->target_buffering + ap->output_buffer),
+         underflows, SAMPLES_TO_MS(stats->silence));
+
+    memset(stats, 0, sizeof(*stats));
+}
+
+static bool
+sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
+                                const AVFrame *frame) {
+    struct sc_audio_player *ap = DOWNCAST(sink);
+
+    SwrContext *swr_ctx = ap->swr_ctx;
 
-            // It should remain exactly the expected size to write the new
-            // samples.
-            assert(sc_audiobuf_can_write(&ap->buf) == samples_written);
+    // Number of samples produced, and actually written to the audio buffer
+    // (this function is the only producer, so it never waits for the SDL
+    // callback: if the consumer is stalled and the buffer is full, the oldest
+    // samples are dropped to make room for the new ones)
+    uint32_t samples_written;
+    uint32_t written;
+    // Number of old samples dropped to make room
+    uint32_t dropped = 0;
+
+    if (!ap->compensation && sc_audio_player_can_write_direct(frame)) {
+        // Fast path: no resampling is needed, convert the samples directly to
+        // the audio buffer
+        uint32_t flushed_written;
+        int flushed = sc_audio_player_flush_swr(ap, &flushed_written,
+                                                &dropped);
+        if (flushed < 0) {
+            return false;
         }
 
-        sc_audiobuf_write(&ap->buf, swr_buf, samples_written);
+        samples_written = flushed + frame->nb_samples;
+        written = flushed_written
+                + sc_audio_player_write_direct(ap, frame, &dropped);
+    } else {
+        int64_t swr_delay = swr_get_delay(swr_ctx, ap->sample_rate);
+        // No need to av_rescale_rnd(), input and output sample rates are the
+        // same. Add more space (256) for clock compensation.
+        int dst_nb_samples = swr_delay + frame->nb_samples + 256;
+
+        uint8_t *swr_buf = sc_audio_player_get_swr_buf(ap, dst_nb_samples);
+        if (!swr_buf) {
+            return false;
+        }
+
+        int ret = swr_convert(swr_ctx, &swr_buf, dst_nb_samples,
+                              (const uint8_t **) frame->data,
+                              frame->nb_samples);
+        if (ret < 0) {
+            LOGE("Resampling failed: %d", ret);
+            return false;
+        }
+
+        // swr_convert() returns the number of samples which would have been
+        // written if the buffer was big enough.
+        samples_written = MIN(ret, dst_nb_samples);
+        dropped += sc_audio_player_make_room(ap, samples_written);
+        written = sc_audiobuf_write(&ap->buf, swr_buf, samples_written);
     }
 
-    buffered_samples += samples_written;
-    assert(buffered_samples == sc_audiobuf_can_read(&ap->buf));
+#ifndef SC_AUDIO_PLAYER_NDEBUG
+    LOGD("[Audio] %" PRIu32 " samples written to buffer", samples_written);
+#endif
+
+    bool played = atomic_load_explicit(&ap->played, memory_order_relaxed);
 
-    // Read with lock held, to be used after unlocking
-    bool played = ap->played;
-    uint32_t underflow = ap->underflow;
+    // Only a single frame larger than the whole buffer could be truncated
+    dropped += samples_written - written;
+    if (dropped) {
+        LOGD("[Audio] Buffer overflow, dropping %" PRIu32 " samples",
+             dropped);
+        if (played) {
+            // Dropping input samples instantly decreases buffering
+            ap->avg_buffering.avg -= dropped;
+        }
+    }
 
+    // The consumer may read samples concurrently, so this is an upper bound
+    uint32_t buffered_samples = sc_audiobuf_can_read(&ap->buf);
+
+    uint32_t underflow = 0;
     if (played) {
         uint32_t max_buffered_samples = ap->target_buffering
                                       + 12 * ap->output_buffer
                                       + ap->target_buffering / 10;
         if (buffered_samples > max_buffered_samples) {
             uint32_t skip_samples = buffered_samples - max_buffered_samples;
-            sc_audiobuf_skip(&ap->buf, skip_samples);
+            // Replace any previous request, it is recomputed from the current
+            // buffering level, which still includes the samples not skipped
+            // yet
+            atomic_store_explicit(&ap->skip_request, skip_samples,
+                                  memory_order_relaxed);
             LOGD("[Audio] Buffering threshold exceeded, skipping %" PRIu32
                  " samples", skip_samples);
         }
 
-        // reset (the current value was copied to a local variable)
-        ap->underflow = 0;
+        // Read and reset the silence inserted since the last push
+        underflow = atomic_exchange_explicit(&ap->underflow, 0,
+                                             memory_order_relaxed);
     } else {
         // SDL playback not started yet, do not accumulate more than
         // max_initial_buffering samples, this would cause unnecessary delay
@@ -247,7 +477,8 @@ sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
                                        + 2 * ap->output_buffer;
         if (buffered_samples > max_initial_buffering) {
             uint32_t skip_samples = buffered_samples - max_initial_buffering;
-            sc_audiobuf_skip(&ap->buf, skip_samples);
+            atomic_store_explicit(&ap->skip_request, skip_samples,
+                                  memory_order_relaxed);
 #ifndef SC_AUDIO_PLAYER_NDEBUG
             LOGD("[Audio] Playback not started, skipping %" PRIu32 " samples",
                  skip_samples);
@@ -255,10 +486,7 @@ sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
         }
     }
 
-    ap->previous_can_write = sc_audiobuf_can_write(&ap->buf);
-    ap->received = true;
-
-    SDL_UnlockAudioDevice(ap->device);
+    atomic_store_explicit(&ap->received, true, memory_order_relaxed);
 
     if (played) {
         // Number of samples added (or removed, if negative) for compensation
@@ -278,9 +506,14 @@ sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
              buffered_samples, sc_average_get(&ap->avg_buffering));
 #endif
 
+        if (ap->profile->report_interval) {
+            sc_audio_player_report(ap, buffered_samples, underflow,
+                                   samples_written);
+        }
+
         ap->samples_since_resync += samples_written;
-        if (ap->samples_since_resync >= ap->sample_rate) {
-            // Recompute compensation every second
+        if (ap->samples_since_resync >= ap->resync_samples) {
+            // Recompute compensation regularly (every second by default)
             ap->samples_since_resync = 0;
 
             float avg = sc_average_get(&ap->avg_buffering);
@@ -293,11 +526,12 @@ sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
                 // the average, this would increase underflow
                 diff = 0;
             }
-            // Compensate the diff over 4 seconds (but will be recomputed after
-            // 1 second)
-            int distance = 4 * ap->sample_rate;
-            // Limit compensation rate to 2%
-            int abs_max_diff = distance / 50;
+            // Compensate the diff over 4 seconds by default (but will be
+            // recomputed after 1 second)
+            int distance = ap->compensation_distance;
+            // Limit compensation rate (to 2% by default)
+            int abs_max_diff =
+                distance * ap->profile->max_compensation_percent / 100;
             diff = CLAMP(diff, -abs_max_diff, abs_max_diff);
             LOGV("[Audio] Buffering: target=%" PRIu32 " avg=%f cur=%" PRIu32
                  " compensation=%d", ap->target_buffering, avg,
@@ -312,6 +546,10 @@ sc_audio_player_frame_sink_push(struct sc_frame_sink *sink,
                     ap->compensation = diff;
                 }
             }
+
+            if (ap->profile->overflow_resyncs) {
+                sc_audio_player_check_overflow(ap, avg, buffered_samples);
+            }
         }
     }
 
@@ -343,6 +581,12 @@ sc_audio_player_frame_sink_open(struct sc_frame_sink *sink,
     ap->target_buffering = ap->target_buffering_delay * ap->sample_rate
                                                       / SC_TICK_FREQ;
 
+    const struct sc_audio_player_profile *profile = ap->profile;
+    ap->resync_samples = TICK_TO_SAMPLES(profile->resync_interval);
+    ap->compensation_distance = TICK_TO_SAMPLES(profile->compensation_distance);
+    ap->start_margin = TICK_TO_SAMPLES(profile->start_margin);
+    ap->report_samples = TICK_TO_SAMPLES(profile->report_interval);
+
     uint64_t aout_samples = ap->output_buffer_duration * ap->sample_rate
                                                        / SC_TICK_FREQ;
     assert(aout_samples <= 0xFFFF);
@@ -394,9 +638,8 @@ sc_audio_player_frame_sink_open(struct sc_frame_sink *sink,
     }
 
     // Use a ring-buffer of the target buffering size plus 1 second between the
-    // producer and the consumer. It's too big on purpose, to guarantee that
-    // the producer and the consumer will be able to access it in parallel
-    // without locking.
+    // producer and the consumer. It's too big on purpose, so that the producer
+    // never has to drop samples while the consumer is running normally.
     size_t audiobuf_samples = ap->target_buffering + ap->sample_rate;
 
     size_t sample_size = ap->nb_channels * ap->out_bytes_per_sample;
@@ -413,17 +656,19 @@ sc_audio_player_frame_sink_open(struct sc_frame_sink *sink,
     }
     ap->swr_buf_alloc_size = initial_swr_buf_size;
 
-    ap->previous_can_write = sc_audiobuf_can_write(&ap->buf);
-
     // Samples are produced and consumed by blocks, so the buffering must be
     // smoothed to get a relatively stable value.
     sc_average_init(&ap->avg_buffering, 32);
     ap->samples_since_resync = 0;
 
-    ap->received = false;
-    ap->played = false;
-    ap->underflow = 0;
+    atomic_init(&ap->received, false);
+    atomic_init(&ap->played, false);
+    atomic_init(&ap->underflow, 0);
+    atomic_init(&ap->underflow_count, 0);
+    atomic_init(&ap->skip_request, 0);
     ap->compensation = 0;
+    ap->overflow_resyncs = 0;
+    memset(&ap->stats, 0, sizeof(ap->stats));
 
     // The thread calling open() is the thread calling push(), which fills the
     // audio buffer consumed by the SDL audio thread.
@@ -462,9 +707,11 @@ sc_audio_player_frame_sink_close(struct sc_frame_sink *sink) {
 
 void
 sc_audio_player_init(struct sc_audio_player *ap, sc_tick target_buffering,
-                     sc_tick output_buffer_duration) {
+                     sc_tick output_buffer_duration, bool low_latency) {
     ap->target_buffering_delay = target_buffering;
     ap->output_buffer_duration = output_buffer_duration;
+    ap->profile = low_latency ? &sc_audio_player_profile_low_latency
+                              : &sc_audio_player_profile_default;
 
     static const struct sc_frame_sink_ops ops = {
         .open = sc_audio_player_frame_sink_open,
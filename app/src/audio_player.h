@@ -3,6 +3,7 @@
 
 #include "common.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 #include "trait/frame_sink.h"
 #include <util/audiobuf.h>
@@ -14,6 +15,17 @@
 #include <libswresample/swresample.h>
 #include <SDL2/SDL.h>
 
+struct sc_audio_player_profile;
+
+// Statistics for the latency report (only used by the receiver thread)
+struct sc_audio_player_stats {
+    uint64_t buffered_sum; // sum of the buffering levels on each push
+    uint32_t buffered_max;
+    uint32_t pushes;
+    uint32_t silence; // silence samples inserted on underflow
+    uint32_t samples; // samples received since the last report
+};
+
 struct sc_audio_player {
     struct sc_frame_sink frame_sink;
 
@@ -31,13 +43,21 @@ struct sc_audio_player {
     sc_tick output_buffer_duration;
     uint16_t output_buffer;
 
-    // Audio buffer to communicate between the receiver and the SDL audio
-    // callback (protected by SDL_AudioDeviceLock())
+    // Compensation parameters (default or low-latency)
+    const struct sc_audio_player_profile *profile;
+    // Parameters of the profile converted to samples
+    uint32_t resync_samples;
+    uint32_t compensation_distance;
+    uint32_t start_margin;
+    uint32_t report_samples;
+
+    // Audio buffer to communicate between the receiver (producer) and the
+    // SDL audio callback (consumer), without lock
     struct sc_audiobuf buf;
 
-    // The previous empty space in the buffer (only used by the receiver
-    // thread)
-    uint32_t previous_can_write;
+    // Number of old samples the receiver requests the SDL callback to drop
+    // (only the consumer may move the read cursor)
+    atomic_uint_least32_t skip_request;
 
     // Resampler (only used from the receiver thread)
     struct SwrContext *swr_ctx;
@@ -61,19 +81,27 @@ struct sc_audio_player {
     uint32_t samples_since_resync;
 
     // Number of silence samples inserted since the last received packet
-    // (protected by SDL_AudioDeviceLock())
-    uint32_t underflow;
+    // (incremented by the SDL callback, reset by the receiver thread)
+    atomic_uint_least32_t underflow;
 
     // Current applied compensation value (only used by the receiver thread)
     int compensation;
 
-    // Set to true the first time a sample is received (protected by
-    // SDL_AudioDeviceLock())
-    bool received;
+    // Number of consecutive compensation updates with the buffering too high
+    // (only used by the receiver thread)
+    unsigned overflow_resyncs;
+
+    // Number of underflow events since the last report (incremented by the
+    // SDL callback, reset by the receiver thread)
+    atomic_uint_least32_t underflow_count;
+
+    struct sc_audio_player_stats stats;
+
+    // Set to true the first time a sample is received
+    atomic_bool received;
 
-    // Set to true the first time the SDL callback is called (protected by
-    // SDL_AudioDeviceLock())
-    bool played;
+    // Set to true the first time the SDL callback is called
+    atomic_bool played;
 
     const struct sc_audio_player_callbacks *cbs;
     void *cbs_userdata;
@@ -85,6 +113,6 @@ struct sc_audio_player_callbacks {
 
 void
 sc_audio_player_init(struct sc_audio_player *ap, sc_tick target_buffering,
-                     sc_tick audio_output_buffer);
+                     sc_tick audio_output_buffer, bool low_latency);
 
 #endif
@@ -93,6 +93,19 @@ enum {
     OPT_DISPLAY_ORIENTATION,
     OPT_RECORD_ORIENTATION,
     OPT_ORIENTATION,
+    OPT_NO_TCP_NODELAY,
+    OPT_SOCKET_SEND_BUFFER,
+    OPT_TUNE_VIDEO_SOCKET,
+    OPT_PRINT_INPUT_LATENCY,
+    OPT_VIDEO_DECODER_THREADS,
+    OPT_DUMP_STREAM,
+    OPT_REPLAY_STREAM,
+    OPT_REPLAY_FAST,
+    OPT_FRAME_POLICY,
+    OPT_FRAME_RING_SIZE,
+    OPT_NO_PBO,
+    OPT_RENDER_ROI,
+    OPT_AUDIO_LOW_LATENCY,
 };
 
 struct sc_option {
@@ -149,7 +162,7 @@ static const struct sc_option options[] = {
         .text = "Configure the audio buffering delay (in milliseconds).\n"
                 "Lower values decrease the latency, but increase the "
                 "likelyhood of buffer underrun (causing audio glitches).\n"
-                "Default is 50.",
+                "Default is 50 (30 with --audio-low-latency).",
     },
     {
         .longopt_id = OPT_AUDIO_CODEC,
@@ -178,6 +191,16 @@ static const struct sc_option options[] = {
                 "codec provided by --audio-codec).\n"
                 "The available encoders can be listed by --list-encoders.",
     },
+    {
+        .longopt_id = OPT_AUDIO_LOW_LATENCY,
+        .longopt = "audio-low-latency",
+        .text = "Play audio with a low-latency profile: smaller SDL audio "
+                "output buffer and audio buffering by default, faster and "
+                "stronger clock compensation, and drop of old samples if the "
+                "buffering stays too high.\n"
+                "The achieved latency and the number of buffer underruns are "
+                "reported regularly.",
+    },
     {
         .longopt_id = OPT_AUDIO_SOURCE,
         .longopt = "audio-source",
@@ -193,7 +216,7 @@ static const struct sc_option options[] = {
                 "milliseconds).\n"
                 "If you get \"robotic\" audio playback, you should test with "
                 "a higher value (10). Do not change this setting otherwise.\n"
-                "Default is 5.",
+                "Default is 5 (2 with --audio-low-latency).",
     },
     {
         .shortopt = 'b',
@@ -298,9 +321,12 @@ static const struct sc_option options[] = {
     {
         .longopt_id = OPT_DISPLAY_BUFFER,
         .longopt = "display-buffer",
-        .argdesc = "ms",
+        .argdesc = "ms[:max_ms]",
         .text = "Add a buffering delay (in milliseconds) before displaying. "
                 "This increases latency to compensate for jitter.\n"
+                "If max_ms is provided, the delay is adapted to the measured "
+                "jitter between ms and max_ms: it grows when frames are late, "
+                "and shrinks slowly when the connection is stable.\n"
                 "Default is 0 (no buffering).",
     },
     {
@@ -323,6 +349,14 @@ static const struct sc_option options[] = {
                 "before the rotation.\n"
                 "Default is 0.",
     },
+    {
+        .longopt_id = OPT_DUMP_STREAM,
+        .longopt = "dump-stream",
+        .argdesc = "file",
+        .text = "Write the raw streams exactly as received from the device "
+                "to \"<file>.video\" and \"<file>.audio\", to replay them "
+                "later with --replay-stream.",
+    },
     {
         .shortopt = 'e',
         .longopt = "select-tcpip",
@@ -353,6 +387,31 @@ static const struct sc_option options[] = {
                 "middle-click triggers HOME. This option disables these "
                 "shortcuts and forwards the clicks to the device instead.",
     },
+    {
+        .longopt_id = OPT_FRAME_POLICY,
+        .longopt = "frame-policy",
+        .argdesc = "value",
+        .text = "Select what to do with the decoded frames when the display "
+                "is slower than the decoder.\n"
+                "Possible values are \"latest\" (only render the last "
+                "decoded frame), \"ring\" (keep up to --frame-ring-size "
+                "frames, for smoothness at the cost of latency) and "
+                "\"decode-drop\" (like \"latest\", but also skip the "
+                "decoding of non-reference frames while the display is "
+                "behind, if the encoder produces such frames).\n"
+                "\"decode-drop\" is not compatible with --display-buffer and "
+                "--v4l2-sink (the decoder could never know that the frames "
+                "are late).\n"
+                "Default is latest.",
+    },
+    {
+        .longopt_id = OPT_FRAME_RING_SIZE,
+        .longopt = "frame-ring-size",
+        .argdesc = "value",
+        .text = "Set the maximum number of frames waiting to be rendered with "
+                "--frame-policy=ring (between 2 and 16).\n"
+                "Default is 3.",
+    },
     {
         .shortopt = 'h',
         .longopt = "help",
@@ -511,11 +570,29 @@ static const struct sc_option options[] = {
                 "mipmaps are automatically generated to improve downscaling "
                 "quality. This option disables the generation of mipmaps.",
     },
+    {
+        .longopt_id = OPT_NO_PBO,
+        .longopt = "no-pbo",
+        .text = "If the renderer is OpenGL 3.2+ or OpenGL ES 3.0+, then "
+                "frames are uploaded to the texture through pixel buffer "
+                "objects, to avoid a blocking copy on each frame. This option "
+                "disables them.",
+    },
     {
         .longopt_id = OPT_NO_POWER_ON,
         .longopt = "no-power-on",
         .text = "Do not power on the device on start.",
     },
+    {
+        .longopt_id = OPT_NO_TCP_NODELAY,
+        .longopt = "no-tcp-nodelay",
+        .text = "By default, TCP_NODELAY (and TCP_QUICKACK on Linux, re-armed "
+                "after each receive) are enabled on the control socket, so "
+                "that small input events are sent immediately instead of "
+                "being delayed by Nagle's algorithm, and device messages are "
+                "acknowledged without delay.\n"
+                "This option disables them.",
+    },
     {
         .longopt_id = OPT_NO_VIDEO,
         .longopt = "no-video",
@@ -588,7 +665,19 @@ static const struct sc_option options[] = {
         .longopt_id = OPT_PRINT_FPS,
         .longopt = "print-fps",
         .text = "Start FPS counter, to print framerate logs to the console. "
-                "It can be started or stopped at any time with MOD+i.",
+                "It can be started or stopped at any time with MOD+i.\n"
+                "If --display-buffer is set, the buffering statistics (late "
+                "frames and headroom before presentation) are printed "
+                "along. If --v4l2-buffer is set, the statistics of the V4L2 "
+                "buffer are printed every second.",
+    },
+    {
+        .longopt_id = OPT_PRINT_INPUT_LATENCY,
+        .longopt = "print-input-latency",
+        .text = "Print input latency statistics to the console every second: "
+                "time spent by control messages in the queue, and time to "
+                "write them to the socket (p50, p99 and max, in "
+                "microseconds).",
     },
     {
         .longopt_id = OPT_PUSH_TARGET,
@@ -637,6 +726,33 @@ static const struct sc_option options[] = {
                 "\"opengles2\", \"opengles\", \"metal\" and \"software\".\n"
                 "<https://wiki.libsdl.org/SDL_HINT_RENDER_DRIVER>",
     },
+    {
+        .longopt_id = OPT_RENDER_ROI,
+        .longopt = "render-roi",
+        .argdesc = "width:height[:x:y]",
+        .text = "Only upload and render the given region of the video frames "
+                "(e.g. the center of the screen in a game), to reduce the "
+                "texture bandwidth.\n"
+                "The region is centered if x and y are not provided.\n"
+                "It can be toggled with the whole frame at any time with "
+                "MOD+z.",
+    },
+    {
+        .longopt_id = OPT_REPLAY_FAST,
+        .longopt = "replay-fast",
+        .text = "Replay the streams as fast as possible instead of at their "
+                "original pace (see --replay-stream).",
+    },
+    {
+        .longopt_id = OPT_REPLAY_STREAM,
+        .longopt = "replay-stream",
+        .argdesc = "file",
+        .text = "Play the streams written by --dump-stream from "
+                "\"<file>.video\" and \"<file>.audio\" instead of "
+                "connecting to a device (unless --no-video or --no-audio is "
+                "passed).\n"
+                "Control is disabled.",
+    },
     {
         .longopt_id = OPT_REQUIRE_AUDIO,
         .longopt = "require-audio",
@@ -682,6 +798,14 @@ static const struct sc_option options[] = {
                 "on exit.\n"
                 "It only shows physical touches (not clicks from scrcpy).",
     },
+    {
+        .longopt_id = OPT_SOCKET_SEND_BUFFER,
+        .longopt = "socket-send-buffer",
+        .argdesc = "size",
+        .text = "Set the kernel send buffer size of the control socket, in "
+                "bytes. Supports suffix 'K' (x1000) and 'M' (x1000000).\n"
+                "Default is 0 (system default).",
+    },
     {
         .longopt_id = OPT_TCPIP,
         .longopt = "tcpip",
@@ -721,6 +845,12 @@ static const struct sc_option options[] = {
                 "Default is 0 (not forced): the local port used for "
                 "establishing the tunnel will be used.",
     },
+    {
+        .longopt_id = OPT_TUNE_VIDEO_SOCKET,
+        .longopt = "tune-video-socket",
+        .text = "Also apply the low-latency socket options (see "
+                "--no-tcp-nodelay) to the video socket.",
+    },
     {
         .shortopt = 'v',
         .longopt = "version",
@@ -749,7 +879,7 @@ static const struct sc_option options[] = {
     {
         .longopt_id = OPT_V4L2_BUFFER,
         .longopt = "v4l2-buffer",
-        .argdesc = "ms",
+        .argdesc = "ms[:max_ms]",
         .text = "Add a buffering delay (in milliseconds) before pushing "
                 "frames. This increases latency to compensate for jitter.\n"
                 "This option is similar to --display-buffer, but specific to "
@@ -776,6 +906,18 @@ static const struct sc_option options[] = {
                 "Android documentation: "
                 "<https://d.android.com/reference/android/media/MediaFormat>",
     },
+    {
+        .longopt_id = OPT_VIDEO_DECODER_THREADS,
+        .longopt = "video-decoder-threads",
+        .argdesc = "value",
+        .text = "Set the number of threads used to decode the video.\n"
+                "Only slice threading is used, so that no frame delay is "
+                "added. It is effective only if the stream contains several "
+                "slices per frame (or uses wavefront parallel processing for "
+                "H.265).\n"
+                "Default is 0 (automatic, depending on the number of CPU "
+                "cores and on the video resolution).",
+    },
     {
         .longopt_id = OPT_VIDEO_ENCODER,
         .longopt = "video-encoder",
@@ -945,6 +1087,11 @@ static const struct sc_shortcut shortcuts[] = {
         .shortcuts = { "MOD+i" },
         .text = "Enable/disable FPS counter (print frames/second in logs)",
     },
+    {
+        .shortcuts = { "MOD+z" },
+        .text = "Render the region of interest (--render-roi) or the whole "
+                "frame",
+    },
     {
         .shortcuts = { "Ctrl+click-and-move" },
         .text = "Pinch-to-zoom from the center of the screen",
@@ -1378,6 +1525,108 @@ parse_max_fps(const char *s, uint16_t *max_fps) {
     return true;
 }
 
+static bool
+parse_socket_send_buffer(const char *s, uint32_t *size) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, true, 0, 0x7FFFFFFF,
+                                "socket send buffer");
+    if (!ok) {
+        return false;
+    }
+
+    *size = (uint32_t) value;
+    return true;
+}
+
+static bool
+parse_video_decoder_threads(const char *s, uint16_t *threads) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, false, 0, 16,
+                                "video decoder threads");
+    if (!ok) {
+        return false;
+    }
+
+    *threads = (uint16_t) value;
+    return true;
+}
+
+static bool
+parse_frame_policy(const char *s, enum sc_frame_policy *policy) {
+    if (!strcmp(s, "latest")) {
+        *policy = SC_FRAME_POLICY_LATEST;
+        return true;
+    }
+    if (!strcmp(s, "ring")) {
+        *policy = SC_FRAME_POLICY_RING;
+        return true;
+    }
+    if (!strcmp(s, "decode-drop")) {
+        *policy = SC_FRAME_POLICY_DECODE_DROP;
+        return true;
+    }
+    LOGE("Unsupported frame policy: %s (expected latest, ring or "
+         "decode-drop)", s);
+    return false;
+}
+
+static bool
+parse_frame_ring_size(const char *s, uint8_t *size) {
+    long value;
+    bool ok = parse_integer_arg(s, &value, false, 2, 16, "frame ring size");
+    if (!ok) {
+        return false;
+    }
+
+    *size = (uint8_t) value;
+    return true;
+}
+
+static bool
+parse_render_roi(const char *s, struct sc_roi *roi) {
+    long values[4];
+    size_t count = parse_integers_arg(s, ':', 4, values, 0, 0xFFFF,
+                                      "render region");
+    if (!count) {
+        return false;
+    }
+
+    if (count != 2 && count != 4) {
+        LOGE("Invalid render region (expected width:height[:x:y]): %s", s);
+        return false;
+    }
+
+    if (values[0] < 2 || values[1] < 2) {
+        LOGE("Render region too small: %s", s);
+        return false;
+    }
+
+    roi->width = values[0];
+    roi->height = values[1];
+    roi->x = count == 4 ? values[2] : -1;
+    roi->y = count == 4 ? values[3] : -1;
+    return true;
+}
+
+static bool
+parse_buffering_range(const char *s, sc_tick *min, sc_tick *max) {
+    long values[2];
+    size_t count = parse_integers_arg(s, ':', 2, values, 0, 0x7FFFFFFF,
+                                      "buffering time");
+    if (!count) {
+        return false;
+    }
+
+    if (count == 2 && (!values[0] || values[0] > values[1])) {
+        LOGE("Invalid buffering range (expected 0 < ms <= max_ms): %s", s);
+        return false;
+    }
+
+    *min = SC_TICK_FROM_MS(values[0]);
+    *max = count == 2 ? SC_TICK_FROM_MS(values[1]) : *min;
+    return true;
+}
+
 static bool
 parse_buffering_time(const char *s, sc_tick *tick) {
     long value;
@@ -2169,6 +2418,9 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_NO_MIPMAPS:
                 opts->mipmaps = false;
                 break;
+            case OPT_NO_PBO:
+                opts->pbo = false;
+                break;
             case OPT_NO_KEY_REPEAT:
                 opts->forward_key_repeat = false;
                 break;
@@ -2213,7 +2465,8 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                 opts->power_off_on_close = true;
                 break;
             case OPT_DISPLAY_BUFFER:
-                if (!parse_buffering_time(optarg, &opts->display_buffer)) {
+                if (!parse_buffering_range(optarg, &opts->display_buffer,
+                                           &opts->display_buffer_max)) {
                     return false;
                 }
                 break;
@@ -2239,6 +2492,9 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_NO_POWER_ON:
                 opts->power_on = false;
                 break;
+            case OPT_PRINT_INPUT_LATENCY:
+                opts->print_input_latency = true;
+                break;
             case OPT_PRINT_FPS:
                 opts->start_fps_counter = true;
                 break;
@@ -2275,7 +2531,8 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
 #endif
             case OPT_V4L2_BUFFER:
 #ifdef HAVE_V4L2
-                if (!parse_buffering_time(optarg, &opts->v4l2_buffer)) {
+                if (!parse_buffering_range(optarg, &opts->v4l2_buffer,
+                                           &opts->v4l2_buffer_max)) {
                     return false;
                 }
                 break;
@@ -2310,6 +2567,9 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
                     return false;
                 }
                 break;
+            case OPT_AUDIO_LOW_LATENCY:
+                opts->audio_low_latency = true;
+                break;
             case OPT_VIDEO_SOURCE:
                 if (!parse_video_source(optarg, &opts->video_source)) {
                     return false;
@@ -2323,6 +2583,48 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             case OPT_KILL_ADB_ON_CLOSE:
                 opts->kill_adb_on_close = true;
                 break;
+            case OPT_NO_TCP_NODELAY:
+                opts->tcp_nodelay = false;
+                break;
+            case OPT_SOCKET_SEND_BUFFER:
+                if (!parse_socket_send_buffer(optarg,
+                                              &opts->socket_send_buffer)) {
+                    return false;
+                }
+                break;
+            case OPT_VIDEO_DECODER_THREADS:
+                if (!parse_video_decoder_threads(
+                        optarg, &opts->video_decoder_threads)) {
+                    return false;
+                }
+                break;
+            case OPT_DUMP_STREAM:
+                opts->dump_stream = optarg;
+                break;
+            case OPT_REPLAY_STREAM:
+                opts->replay_stream = optarg;
+                break;
+            case OPT_REPLAY_FAST:
+                opts->replay_fast = true;
+                break;
+            case OPT_FRAME_POLICY:
+                if (!parse_frame_policy(optarg, &opts->frame_policy)) {
+                    return false;
+                }
+                break;
+            case OPT_FRAME_RING_SIZE:
+                if (!parse_frame_ring_size(optarg, &opts->frame_ring_size)) {
+                    return false;
+                }
+                break;
+            case OPT_RENDER_ROI:
+                if (!parse_render_roi(optarg, &opts->render_roi)) {
+                    return false;
+                }
+                break;
+            case OPT_TUNE_VIDEO_SOCKET:
+                opts->tune_video_socket = true;
+                break;
             case OPT_TIME_LIMIT:
                 if (!parse_time_limit(optarg, &opts->time_limit)) {
                     return false;
@@ -2429,11 +2731,19 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
             LOGI("FLAC audio: audio buffer increased to 120 ms (use "
                  "--audio-buffer to set a custom value)");
             opts->audio_buffer = SC_TICK_FROM_MS(120);
+        } else if (opts->audio_low_latency) {
+            opts->audio_buffer = SC_TICK_FROM_MS(30);
         } else {
             opts->audio_buffer = SC_TICK_FROM_MS(50);
         }
     }
 
+    if (opts->audio_playback && opts->audio_output_buffer == -1) {
+        opts->audio_output_buffer = opts->audio_low_latency
+                                  ? SC_TICK_FROM_MS(2)
+                                  : SC_TICK_FROM_MS(5);
+    }
+
 #ifdef HAVE_V4L2
     if (v4l2) {
         if (opts->lock_video_orientation ==
@@ -2455,6 +2765,31 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
     }
 #endif
 
+    if (opts->frame_ring_size && opts->frame_policy != SC_FRAME_POLICY_RING) {
+        LOGE("--frame-ring-size is only available with --frame-policy=ring");
+        return false;
+    }
+
+    if (opts->frame_policy == SC_FRAME_POLICY_RING && !opts->frame_ring_size) {
+        opts->frame_ring_size = 3;
+    }
+
+    if (opts->frame_policy == SC_FRAME_POLICY_DECODE_DROP) {
+        // The decoder only skips frames if all its frame sinks report that
+        // they are late, which the delay buffers and the V4L2 sink never do
+        if (opts->display_buffer) {
+            LOGE("--frame-policy=decode-drop is not compatible with "
+                 "--display-buffer");
+            return false;
+        }
+
+        if (v4l2) {
+            LOGE("--frame-policy=decode-drop is not compatible with "
+                 "--v4l2-sink");
+            return false;
+        }
+    }
+
     if ((opts->tunnel_host || opts->tunnel_port) && !opts->force_adb_forward) {
         LOGI("Tunnel host/port is set, "
              "--force-adb-forward automatically enabled.");
@@ -2595,6 +2930,26 @@ parse_args_with_getopt(struct scrcpy_cli_args *args, int argc, char *argv[],
         }
     }
 
+    if (opts->replay_stream) {
+        if (opts->dump_stream) {
+            LOGE("Could not both dump and replay a stream");
+            return false;
+        }
+
+        if (opts->list || otg) {
+            LOGE("Could not replay a stream in list or OTG mode");
+            return false;
+        }
+
+        if (opts->control) {
+            LOGI("Stream replay: control disabled");
+            opts->control = false;
+        }
+    } else if (opts->replay_fast) {
+        LOGE("--replay-fast requires --replay-stream");
+        return false;
+    }
+
     if (!opts->control) {
         if (opts->turn_screen_off) {
             LOGE("Could not request to turn screen off if control is disabled");
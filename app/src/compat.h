@@ -52,6 +52,13 @@
 # define SCRCPY_LAVU_HAS_CHLAYOUT
 #endif
 
+// The size parameter of the AVBufferPool allocation callback is a size_t since
+// libavutil 57 (FF_API_BUFFER_SIZE_T removed on the major bump), it was an
+// int before.
+#if LIBAVUTIL_VERSION_MAJOR >= 57
+# define SCRCPY_LAVU_HAS_BUFFER_SIZE_T
+#endif
+
 // In ffmpeg/doc/APIchanges:
 // 2023-10-06 - 5432d2aacad - lavc 60.15.100 - avformat.h
 //   Deprecate AVFormatContext.{nb_,}side_data, av_stream_add_side_data(),
@@ -10,6 +10,7 @@
 #include "android/input.h"
 #include "android/keycodes.h"
 #include "coords.h"
+#include "util/tick.h"
 
 #define SC_CONTROL_MSG_MAX_SIZE (1 << 18) // 256k
 
@@ -53,6 +54,9 @@ enum sc_copy_key {
 
 struct sc_control_msg {
     enum sc_control_msg_type type;
+    // Host time of the input event which generated the message, or of the
+    // push if unknown (not serialized), set by sc_controller_push_msg_at()
+    sc_tick timestamp;
     union {
         struct {
             enum android_keyevent_action action;
@@ -0,0 +1,90 @@
+#include "control_msg_queue.h"
+
+#include <assert.h>
+
+#include "util/log.h"
+
+static bool
+is_touch_move(const struct sc_control_msg *msg) {
+    if (msg->type != SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT) {
+        return false;
+    }
+    enum android_motionevent_action action = msg->inject_touch_event.action;
+    return action == AMOTION_EVENT_ACTION_MOVE
+        || action == AMOTION_EVENT_ACTION_HOVER_MOVE;
+}
+
+static bool
+is_droppable(const struct sc_control_msg *msg) {
+    // A MOVE or a scroll event may be dropped, the next one will carry the
+    // up-to-date state. Dropping any other event (typically a touch DOWN/UP
+    // or a key event) would leave the device in an inconsistent state.
+    return is_touch_move(msg)
+        || msg->type == SC_CONTROL_MSG_TYPE_INJECT_SCROLL_EVENT;
+}
+
+// Replace a pending (not sent yet) MOVE for the same pointer by msg
+static bool
+coalesce_move(struct sc_control_msg_queue *queue,
+              const struct sc_control_msg *msg) {
+    assert(is_touch_move(msg));
+
+    uint64_t pointer_id = msg->inject_touch_event.pointer_id;
+
+    // Find the last pending message for this pointer
+    size_t i = sc_vecdeque_size(queue);
+    while (i--) {
+        struct sc_control_msg *pending = sc_vecdeque_getref(queue, i);
+        if (pending->type != SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT
+                || pending->inject_touch_event.pointer_id != pointer_id) {
+            continue;
+        }
+
+        // Never move an event across a DOWN or UP of the same pointer
+        if (pending->inject_touch_event.action
+                    != msg->inject_touch_event.action
+                || pending->inject_touch_event.buttons
+                    != msg->inject_touch_event.buttons) {
+            return false;
+        }
+
+        // MOVE positions are absolute, only the last one matters. The pending
+        // message keeps its (older) timestamp.
+        pending->inject_touch_event.position =
+            msg->inject_touch_event.position;
+        pending->inject_touch_event.pressure =
+            msg->inject_touch_event.pressure;
+        return true;
+    }
+
+    return false;
+}
+
+bool
+sc_control_msg_queue_push(struct sc_control_msg_queue *queue,
+                          const struct sc_control_msg *msg, size_t max) {
+    if (is_touch_move(msg) && coalesce_move(queue, msg)) {
+        // The pending message has been updated in place
+        return true;
+    }
+
+    if (sc_vecdeque_size(queue) < max) {
+        // The queue capacity is at least max
+        sc_vecdeque_push_noresize(queue, *msg);
+        return true;
+    }
+
+    if (is_droppable(msg)) {
+        // The msg is discarded
+        return false;
+    }
+
+    // Grow the queue rather than losing a DOWN/UP or key event
+    bool ok = sc_vecdeque_push(queue, *msg);
+    if (!ok) {
+        LOG_OOM();
+        return false;
+    }
+
+    return true;
+}
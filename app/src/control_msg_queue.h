@@ -0,0 +1,32 @@
+#ifndef SC_CONTROL_MSG_QUEUE_H
+#define SC_CONTROL_MSG_QUEUE_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "control_msg.h"
+#include "util/vecdeque.h"
+
+struct sc_control_msg_queue SC_VECDEQUE(struct sc_control_msg);
+
+/**
+ * Push a control message to the queue (the caller handles the locking)
+ *
+ * The queue capacity must be at least max.
+ *
+ * A MOVE replaces the pending (not sent yet) MOVE of the same pointer, if no
+ * DOWN or UP of this pointer has been queued since.
+ *
+ * If the queue already contains max messages, a droppable message (a MOVE or
+ * a scroll event) is discarded, but any other message (typically a touch
+ * DOWN/UP or a key event) grows the queue.
+ *
+ * Return true if the message has been pushed or merged.
+ */
+bool
+sc_control_msg_queue_push(struct sc_control_msg_queue *queue,
+                          const struct sc_control_msg *msg, size_t max);
+
+#endif
@@ -6,9 +6,11 @@
 
 #define SC_CONTROL_MSG_QUEUE_MAX 64
 
+#define SC_CONTROLLER_LATENCY_REPORT_INTERVAL SC_TICK_FROM_SEC(1)
+
 bool
 sc_controller_init(struct sc_controller *controller, sc_socket control_socket,
-                   struct sc_acksync *acksync) {
+                   struct sc_acksync *acksync, bool print_latency) {
     sc_vecdeque_init(&controller->queue);
 
     bool ok = sc_vecdeque_reserve(&controller->queue, SC_CONTROL_MSG_QUEUE_MAX);
@@ -39,10 +41,24 @@ sc_controller_init(struct sc_controller *controller, sc_socket control_socket,
 
     controller->control_socket = control_socket;
     controller->stopped = false;
+    controller->stats.msgs = 0;
+    controller->stats.writes = 0;
+
+    controller->latency.enabled = print_latency;
+    sc_histogram_reset(&controller->latency.queue);
+    sc_histogram_reset(&controller->latency.send);
+    controller->latency.next_report = 0;
+    controller->latency.reported_msgs = 0;
+    controller->latency.reported_writes = 0;
 
     return true;
 }
 
+void
+sc_controller_set_quickack(struct sc_controller *controller, bool quickack) {
+    controller->receiver.quickack = quickack;
+}
+
 void
 sc_controller_destroy(struct sc_controller *controller) {
     sc_cond_destroy(&controller->msg_cond);
@@ -61,42 +77,133 @@ sc_controller_destroy(struct sc_controller *controller) {
 bool
 sc_controller_push_msg(struct sc_controller *controller,
                        const struct sc_control_msg *msg) {
+    return sc_controller_push_msg_at(controller, msg, sc_tick_now());
+}
+
+bool
+sc_controller_push_msg_at(struct sc_controller *controller,
+                          const struct sc_control_msg *msg, sc_tick timestamp) {
     if (sc_get_log_level() <= SC_LOG_LEVEL_VERBOSE) {
         sc_control_msg_log(msg);
     }
 
+    struct sc_control_msg stamped = *msg;
+    stamped.timestamp = timestamp;
+
     sc_mutex_lock(&controller->mutex);
-    bool full = sc_vecdeque_is_full(&controller->queue);
-    if (!full) {
-        bool was_empty = sc_vecdeque_is_empty(&controller->queue);
-        sc_vecdeque_push_noresize(&controller->queue, *msg);
-        if (was_empty) {
-            sc_cond_signal(&controller->msg_cond);
+    bool was_empty = sc_vecdeque_is_empty(&controller->queue);
+    bool pushed = sc_control_msg_queue_push(&controller->queue, &stamped,
+                                            SC_CONTROL_MSG_QUEUE_MAX);
+    if (pushed && was_empty) {
+        sc_cond_signal(&controller->msg_cond);
+    }
+    sc_mutex_unlock(&controller->mutex);
+
+    return pushed;
+}
+
+static bool
+send_batch(struct sc_controller *controller, const unsigned char *buf,
+           size_t len, unsigned msg_count, sc_tick dequeued) {
+    ssize_t w = net_send_all(controller->control_socket, buf, len);
+    if ((size_t) w != len) {
+        return false;
+    }
+
+    ++controller->stats.writes;
+    controller->stats.msgs += msg_count;
+
+    if (controller->latency.enabled) {
+        sc_tick duration = sc_tick_now() - dequeued;
+        for (unsigned i = 0; i < msg_count; ++i) {
+            sc_histogram_add(&controller->latency.send, duration);
         }
     }
 
-    sc_mutex_unlock(&controller->mutex);
+    return true;
+}
 
-    return !full;
+static void
+report_latency(struct sc_controller *controller, sc_tick now) {
+    struct sc_histogram *queue = &controller->latency.queue;
+    struct sc_histogram *send = &controller->latency.send;
+    if (queue->count) {
+        // Batching since the last report
+        uint64_t msgs =
+            controller->stats.msgs - controller->latency.reported_msgs;
+        uint64_t writes =
+            controller->stats.writes - controller->latency.reported_writes;
+        LOGI("Input latency (us): queue p50=%" PRItick " p99=%" PRItick
+             " max=%" PRItick ", send p50=%" PRItick " p99=%" PRItick
+             " max=%" PRItick " (%" PRIu64_ " msgs, %.2f msgs/write)",
+             sc_histogram_percentile(queue, 50),
+             sc_histogram_percentile(queue, 99), queue->max,
+             sc_histogram_percentile(send, 50),
+             sc_histogram_percentile(send, 99), send->max, queue->count,
+             writes ? (double) msgs / writes : 0.0);
+    }
+
+    sc_histogram_reset(queue);
+    sc_histogram_reset(send);
+    controller->latency.reported_msgs = controller->stats.msgs;
+    controller->latency.reported_writes = controller->stats.writes;
+    controller->latency.next_report =
+        now + SC_CONTROLLER_LATENCY_REPORT_INTERVAL;
 }
 
 static bool
-process_msg(struct sc_controller *controller,
-            const struct sc_control_msg *msg) {
-    static unsigned char serialized_msg[SC_CONTROL_MSG_MAX_SIZE];
-    size_t length = sc_control_msg_serialize(msg, serialized_msg);
-    if (!length) {
+process_msgs(struct sc_controller *controller, struct sc_control_msg *msgs,
+             unsigned count, sc_tick dequeued) {
+    // Large enough to always serialize one more message as long as no more
+    // than SC_CONTROL_MSG_MAX_SIZE bytes are pending
+    static unsigned char buf[2 * SC_CONTROL_MSG_MAX_SIZE];
+
+    size_t len = 0;
+    unsigned pending_msgs = 0;
+    unsigned i;
+    for (i = 0; i < count; ++i) {
+        if (len > SC_CONTROL_MSG_MAX_SIZE) {
+            if (!send_batch(controller, buf, len, pending_msgs, dequeued)) {
+                break;
+            }
+            len = 0;
+            pending_msgs = 0;
+        }
+
+        size_t msg_len = sc_control_msg_serialize(&msgs[i], &buf[len]);
+        sc_control_msg_destroy(&msgs[i]);
+        if (msg_len) {
+            len += msg_len;
+            ++pending_msgs;
+        }
+    }
+
+    bool ok = i == count;
+    if (!ok) {
+        // Destroy the messages which have not been serialized
+        for (; i < count; ++i) {
+            sc_control_msg_destroy(&msgs[i]);
+        }
         return false;
     }
-    ssize_t w =
-        net_send_all(controller->control_socket, serialized_msg, length);
-    return (size_t) w == length;
+
+    if (len) {
+        ok = send_batch(controller, buf, len, pending_msgs, dequeued);
+    }
+
+    return ok;
 }
 
 static int
 run_controller(void *data) {
     struct sc_controller *controller = data;
 
+    // Only accessed from this thread
+    static struct sc_control_msg msgs[SC_CONTROL_MSG_QUEUE_MAX];
+
+    controller->latency.next_report =
+        sc_tick_now() + SC_CONTROLLER_LATENCY_REPORT_INTERVAL;
+
     for (;;) {
         sc_mutex_lock(&controller->mutex);
         while (!controller->stopped
@@ -109,17 +216,43 @@ run_controller(void *data) {
             break;
         }
 
+        // Drain the queue, so that all the pending messages are sent at once
         assert(!sc_vecdeque_is_empty(&controller->queue));
-        struct sc_control_msg msg = sc_vecdeque_pop(&controller->queue);
+        unsigned count = 0;
+        while (count < ARRAY_LEN(msgs)
+                && !sc_vecdeque_is_empty(&controller->queue)) {
+            msgs[count++] = sc_vecdeque_pop(&controller->queue);
+        }
         sc_mutex_unlock(&controller->mutex);
 
-        bool ok = process_msg(controller, &msg);
-        sc_control_msg_destroy(&msg);
+        sc_tick dequeued = sc_tick_now();
+        if (controller->latency.enabled) {
+            for (unsigned i = 0; i < count; ++i) {
+                sc_histogram_add(&controller->latency.queue,
+                                 dequeued - msgs[i].timestamp);
+            }
+        }
+
+        bool ok = process_msgs(controller, msgs, count, dequeued);
         if (!ok) {
             LOGD("Could not write msg to socket");
             break;
         }
+
+        if (controller->latency.enabled
+                && dequeued >= controller->latency.next_report) {
+            report_latency(controller, dequeued);
+        }
     }
+
+    uint64_t writes = controller->stats.writes;
+    uint64_t msgs_sent = controller->stats.msgs;
+    if (writes) {
+        LOGD("Controller: %" PRIu64_ " msgs sent in %" PRIu64_ " writes "
+             "(%.2f msgs/write)", msgs_sent, writes,
+             (double) msgs_sent / writes);
+    }
+
     return 0;
 }
 
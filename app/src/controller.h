@@ -4,15 +4,15 @@
 #include "common.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "control_msg.h"
+#include "control_msg_queue.h"
 #include "receiver.h"
 #include "util/acksync.h"
+#include "util/histogram.h"
 #include "util/net.h"
 #include "util/thread.h"
-#include "util/vecdeque.h"
-
-struct sc_control_msg_queue SC_VECDEQUE(struct sc_control_msg);
 
 struct sc_controller {
     sc_socket control_socket;
@@ -22,11 +22,34 @@ struct sc_controller {
     bool stopped;
     struct sc_control_msg_queue queue;
     struct sc_receiver receiver;
+
+    // Only accessed from the controller thread
+    struct {
+        uint64_t msgs; // number of messages written to the socket
+        uint64_t writes; // number of socket writes (syscalls)
+    } stats;
+
+    // Input latency, only accessed from the controller thread
+    struct {
+        bool enabled;
+        struct sc_histogram queue; // from the input event to dequeue
+        struct sc_histogram send; // from dequeue to socket write completion
+        sc_tick next_report;
+        // stats values at the last report
+        uint64_t reported_msgs;
+        uint64_t reported_writes;
+    } latency;
 };
 
 bool
 sc_controller_init(struct sc_controller *controller, sc_socket control_socket,
-                   struct sc_acksync *acksync);
+                   struct sc_acksync *acksync, bool print_latency);
+
+// Re-arm TCP_QUICKACK on the control socket after each receive
+//
+// Must be called before sc_controller_start().
+void
+sc_controller_set_quickack(struct sc_controller *controller, bool quickack);
 
 void
 sc_controller_destroy(struct sc_controller *controller);
@@ -44,4 +67,13 @@ bool
 sc_controller_push_msg(struct sc_controller *controller,
                        const struct sc_control_msg *msg);
 
+/**
+ * Push a message generated by an input event received at the given time
+ *
+ * The input latency is measured from this time rather than from the push.
+ */
+bool
+sc_controller_push_msg_at(struct sc_controller *controller,
+                          const struct sc_control_msg *msg, sc_tick timestamp);
+
 #endif
@@ -3,6 +3,7 @@
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/channel_layout.h>
+#include <libavutil/cpu.h>
 
 #include "events.h"
 #include "trait/frame_sink.h"
@@ -43,6 +44,11 @@ sc_decoder_push(struct sc_decoder *decoder, const AVPacket *packet) {
         return true;
     }
 
+    // If the frames would be dropped anyway, do not spend time to decode them
+    // (the reference frames are still needed to decode the next ones)
+    bool late = sc_frame_source_sinks_are_late(&decoder->frame_source);
+    decoder->ctx->skip_frame = late ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+
     int ret = avcodec_send_packet(decoder->ctx, packet);
     if (ret < 0 && ret != AVERROR(EAGAIN)) {
         LOGE("Decoder '%s': could not send video packet: %d",
@@ -94,6 +100,39 @@ sc_decoder_packet_sink_push(struct sc_packet_sink *sink,
     return sc_decoder_push(decoder, packet);
 }
 
+static unsigned
+sc_decoder_get_auto_threads(uint32_t width, uint32_t height) {
+    // Slices split the frame horizontally: below ~270 lines per thread, the
+    // synchronization costs more than it saves (4 threads for 1080p, 8 for
+    // 2160p)
+    uint32_t lines = height > width ? width : height;
+    unsigned threads = lines / 270;
+
+    // Keep a core for the other threads (UI, audio, demuxers)
+    int cpus = av_cpu_count();
+    if (cpus > 1 && threads > (unsigned) cpus - 1) {
+        threads = cpus - 1;
+    }
+
+    if (threads > 16) {
+        threads = 16;
+    }
+
+    return threads ? threads : 1;
+}
+
+void
+sc_decoder_configure_threads(AVCodecContext *ctx, unsigned threads) {
+    if (!threads) {
+        threads = sc_decoder_get_auto_threads(ctx->width, ctx->height);
+    }
+
+    // Frame threading would delay the output by one frame per thread, so
+    // only use slice threading
+    ctx->thread_type = FF_THREAD_SLICE;
+    ctx->thread_count = threads;
+}
+
 void
 sc_decoder_init(struct sc_decoder *decoder, const char *name) {
     decoder->name = name; // statically allocated
@@ -24,4 +24,13 @@ struct sc_decoder {
 void
 sc_decoder_init(struct sc_decoder *decoder, const char *name);
 
+/**
+ * Configure slice threading on a video codec context, before it is opened
+ *
+ * If threads is 0, the number of threads is selected from the number of CPU
+ * cores and the video size (ctx->width and ctx->height must be set).
+ */
+void
+sc_decoder_configure_threads(AVCodecContext *ctx, unsigned threads);
+
 #endif
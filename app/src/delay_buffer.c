@@ -36,6 +36,49 @@ sc_delayed_frame_destroy(struct sc_delayed_frame *dframe) {
     av_frame_free(&dframe->frame);
 }
 
+// Called with the mutex locked
+static void
+sc_delay_buffer_reset_stats(struct sc_delay_buffer *db) {
+    db->stats.frames = 0;
+    db->stats.late = 0;
+    sc_histogram_reset(&db->stats.headroom);
+    sc_histogram_reset(&db->stats.lateness);
+}
+
+// Called with the mutex locked
+static void
+sc_delay_buffer_set_delay(struct sc_delay_buffer *db, sc_tick delay) {
+    db->delay = delay;
+
+    sc_tick diff = delay - db->logged_delay;
+    if (diff >= SC_TICK_FROM_MS(1) || diff <= -SC_TICK_FROM_MS(1)) {
+        LOGD("Buffering delay: %" PRItick " ms", SC_TICK_TO_MS(delay));
+        db->logged_delay = delay;
+    }
+}
+
+// Called with the mutex locked
+static void
+sc_delay_buffer_report_stats(struct sc_delay_buffer *db) {
+    struct sc_histogram *headroom = &db->stats.headroom;
+    struct sc_histogram *lateness = &db->stats.lateness;
+    if (db->stats.frames) {
+        // Only the lowest headroom values matter (the margin before being
+        // late)
+        LOGI("Buffer %s: delay %" PRItick " ms, %" PRIu64_ " frames, "
+             "%" PRIu64_ " late (p50=%" PRItick " max=%" PRItick " ms), "
+             "headroom p1=%" PRItick " p10=%" PRItick " ms",
+             db->name, SC_TICK_TO_MS(db->delay), db->stats.frames,
+             db->stats.late,
+             SC_TICK_TO_MS(sc_histogram_percentile(lateness, 50)),
+             SC_TICK_TO_MS(lateness->max),
+             SC_TICK_TO_MS(sc_histogram_percentile(headroom, 1)),
+             SC_TICK_TO_MS(sc_histogram_percentile(headroom, 10)));
+    }
+
+    sc_delay_buffer_reset_stats(db);
+}
+
 static int
 run_buffering(void *data) {
     struct sc_delay_buffer *db = data;
@@ -56,10 +99,24 @@ run_buffering(void *data) {
 
         struct sc_delayed_frame dframe = sc_vecdeque_pop(&db->queue);
 
-        sc_tick max_deadline = sc_tick_now() + db->delay;
+        sc_tick now = sc_tick_now();
         // PTS (written by the server) are expressed in microseconds
         sc_tick pts = SC_TICK_FROM_US(dframe.frame->pts);
 
+        if (db->adaptive) {
+            sc_tick scheduled = sc_clock_to_system_time(&db->clock, pts)
+                              + db->delay;
+            if (scheduled < now) {
+                // The frame arrived too late to be presented on time
+                struct sc_adaptive_delay *ad = &db->adaptive_delay;
+                if (sc_adaptive_delay_on_late(ad, now, now - scheduled)) {
+                    sc_delay_buffer_set_delay(db, ad->target);
+                }
+            }
+        }
+
+        sc_tick max_deadline = now + db->delay;
+
         bool timed_out = false;
         while (!db->stopped && !timed_out) {
             sc_tick deadline = sc_clock_to_system_time(&db->clock, pts)
@@ -134,6 +191,8 @@ sc_delay_buffer_frame_sink_open(struct sc_frame_sink *sink,
 
     sc_clock_init(&db->clock);
     sc_vecdeque_init(&db->queue);
+    sc_delay_buffer_reset_stats(db);
+    db->next_report = sc_tick_now() + db->report_interval;
 
     if (!sc_frame_source_sinks_open(&db->frame_source, ctx)) {
         goto error_destroy_wait_cond;
@@ -190,8 +249,37 @@ sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
         return false;
     }
 
+    sc_tick now = sc_tick_now();
     sc_tick pts = SC_TICK_FROM_US(frame->pts);
-    sc_clock_update(&db->clock, sc_tick_now(), pts);
+    sc_clock_update(&db->clock, now, pts);
+
+    if (db->adaptive) {
+        struct sc_adaptive_delay *ad = &db->adaptive_delay;
+        if (sc_adaptive_delay_on_arrival(ad, now, pts)) {
+            sc_delay_buffer_set_delay(db, ad->target);
+        }
+    }
+
+    // Compare the arrival with the scheduled presentation time
+    sc_tick scheduled = sc_clock_to_system_time(&db->clock, pts) + db->delay;
+    ++db->stats.frames;
+    if (scheduled < now) {
+        ++db->stats.late;
+        sc_histogram_add(&db->stats.lateness, now - scheduled);
+    } else {
+        sc_histogram_add(&db->stats.headroom, scheduled - now);
+    }
+
+    bool report = atomic_exchange_explicit(&db->report_requested, false,
+                                           memory_order_relaxed);
+    if (db->report_interval && now >= db->next_report) {
+        db->next_report = now + db->report_interval;
+        report = true;
+    }
+    if (report) {
+        sc_delay_buffer_report_stats(db);
+    }
+
     sc_cond_signal(&db->wait_cond);
 
     if (db->first_frame_asap && db->clock.range == 1) {
@@ -225,13 +313,34 @@ sc_delay_buffer_frame_sink_push(struct sc_frame_sink *sink,
 }
 
 void
-sc_delay_buffer_init(struct sc_delay_buffer *db, sc_tick delay,
-                     bool first_frame_asap) {
+sc_delay_buffer_request_report(void *userdata) {
+    struct sc_delay_buffer *db = userdata;
+    atomic_store_explicit(&db->report_requested, true, memory_order_relaxed);
+}
+
+void
+sc_delay_buffer_set_report_interval(struct sc_delay_buffer *db,
+                                    sc_tick interval) {
+    db->report_interval = interval;
+}
+
+void
+sc_delay_buffer_init(struct sc_delay_buffer *db, const char *name,
+                     sc_tick delay, sc_tick max_delay, bool first_frame_asap) {
     assert(delay > 0);
 
+    db->name = name;
     db->delay = delay;
+    atomic_init(&db->report_requested, false);
+    db->report_interval = 0;
+    db->logged_delay = delay;
     db->first_frame_asap = first_frame_asap;
 
+    db->adaptive = max_delay > delay;
+    if (db->adaptive) {
+        sc_adaptive_delay_init(&db->adaptive_delay, delay, max_delay);
+    }
+
     sc_frame_source_init(&db->frame_source);
 
     static const struct sc_frame_sink_ops ops = {
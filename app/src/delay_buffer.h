@@ -3,11 +3,14 @@
 
 #include "common.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
+#include "adaptive_delay.h"
 #include "clock.h"
 #include "trait/frame_source.h"
 #include "trait/frame_sink.h"
+#include "util/histogram.h"
 #include "util/thread.h"
 #include "util/tick.h"
 #include "util/vecdeque.h"
@@ -28,9 +31,15 @@ struct sc_delay_buffer {
     struct sc_frame_source frame_source; // frame source trait
     struct sc_frame_sink frame_sink; // frame sink trait
 
-    sc_tick delay;
+    const char *name; // must be statically allocated (e.g. a string literal)
+
+    sc_tick delay; // current delay (the target delay if adaptive)
     bool first_frame_asap;
 
+    bool adaptive;
+    struct sc_adaptive_delay adaptive_delay;
+    sc_tick logged_delay;
+
     sc_thread thread;
     sc_mutex mutex;
     sc_cond queue_cond;
@@ -39,6 +48,24 @@ struct sc_delay_buffer {
     struct sc_clock clock;
     struct sc_delayed_frame_queue queue;
     bool stopped;
+
+    // Statistics since the last report, protected by the mutex
+    struct {
+        uint64_t frames;
+        // Frames which arrived after their scheduled presentation time
+        uint64_t late;
+        // Delay between arrival and scheduled presentation (for frames on
+        // time)
+        struct sc_histogram headroom;
+        // Delay between scheduled presentation and arrival (for late frames)
+        struct sc_histogram lateness;
+    } stats;
+    // Set by sc_delay_buffer_request_report(), the report is logged on the
+    // next frame
+    atomic_bool report_requested;
+    // If not 0, the report is also logged periodically
+    sc_tick report_interval;
+    sc_tick next_report; // protected by the mutex
 };
 
 struct sc_delay_buffer_callbacks {
@@ -50,11 +77,32 @@ struct sc_delay_buffer_callbacks {
  * Initialize a delay buffer.
  *
  * \param delay a (strictly) positive delay
+ * \param max_delay if greater than delay, the delay is adapted to the jitter
+ *                  of the stream between delay and max_delay
  * \param first_frame_asap if true, do not delay the first frame (useful for
                            a video stream).
  */
 void
-sc_delay_buffer_init(struct sc_delay_buffer *db, sc_tick delay,
-                     bool first_frame_asap);
+sc_delay_buffer_init(struct sc_delay_buffer *db, const char *name,
+                     sc_tick delay, sc_tick max_delay, bool first_frame_asap);
+
+/**
+ * Request to log the statistics since the last report (on the next frame)
+ *
+ * It may be called from any thread, even if the delay buffer is closed. The
+ * signature is compatible with sc_fps_counter_set_reporter().
+ */
+void
+sc_delay_buffer_request_report(void *userdata);
+
+/**
+ * Log the statistics periodically
+ *
+ * This is useful when there is no FPS counter to request the reports. It must
+ * be called before the delay buffer is open.
+ */
+void
+sc_delay_buffer_set_report_interval(struct sc_delay_buffer *db,
+                                    sc_tick interval);
 
 #endif
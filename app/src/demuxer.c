@@ -1,64 +1,84 @@
 #include "demuxer.h"
 
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 #include <libavutil/channel_layout.h>
 #include <libavutil/time.h>
 #include <unistd.h>
 
 #include "decoder.h"
 #include "events.h"
+#include "packet_header.h"
 #include "packet_merger.h"
+#include "packet_pool.h"
 #include "recorder.h"
 #include "util/binary.h"
 #include "util/log.h"
 
-#define SC_PACKET_HEADER_SIZE 12
-
-#define SC_PACKET_FLAG_CONFIG    (UINT64_C(1) << 63)
-#define SC_PACKET_FLAG_KEY_FRAME (UINT64_C(1) << 62)
-
-#define SC_PACKET_PTS_MASK (SC_PACKET_FLAG_KEY_FRAME - 1)
-
-static enum AVCodecID
-sc_demuxer_to_avcodec_id(uint32_t codec_id) {
-#define SC_CODEC_ID_H264 UINT32_C(0x68323634) // "h264" in ASCII
-#define SC_CODEC_ID_H265 UINT32_C(0x68323635) // "h265" in ASCII
-#define SC_CODEC_ID_AV1 UINT32_C(0x00617631) // "av1" in ASCII
-#define SC_CODEC_ID_OPUS UINT32_C(0x6f707573) // "opus" in ASCII
-#define SC_CODEC_ID_AAC UINT32_C(0x00616163) // "aac" in ASCII
-#define SC_CODEC_ID_FLAC UINT32_C(0x666c6163) // "flac" in ASCII
-#define SC_CODEC_ID_RAW UINT32_C(0x00726177) // "raw" in ASCII
-    switch (codec_id) {
-        case SC_CODEC_ID_H264:
-            return AV_CODEC_ID_H264;
-        case SC_CODEC_ID_H265:
-            return AV_CODEC_ID_HEVC;
-        case SC_CODEC_ID_AV1:
-#ifdef SCRCPY_LAVC_HAS_AV1
-            return AV_CODEC_ID_AV1;
-#else
-            LOGE("AV1 not supported by this FFmpeg version");
-            return AV_CODEC_ID_NONE;
-#endif
-        case SC_CODEC_ID_OPUS:
-            return AV_CODEC_ID_OPUS;
-        case SC_CODEC_ID_AAC:
-            return AV_CODEC_ID_AAC;
-        case SC_CODEC_ID_FLAC:
-            return AV_CODEC_ID_FLAC;
-        case SC_CODEC_ID_RAW:
-            return AV_CODEC_ID_PCM_S16LE;
-        default:
-            LOGE("Unknown codec id 0x%08" PRIx32, codec_id);
-            return AV_CODEC_ID_NONE;
+static bool
+sc_demuxer_recv(struct sc_demuxer *demuxer, uint8_t *buf, size_t len) {
+    if (demuxer->replay.file) {
+        if (fread(buf, 1, len, demuxer->replay.file) != len) {
+            return false;
+        }
+    } else {
+        ssize_t r = net_recv_all(demuxer->socket, buf, len);
+        if (r < 0 || (size_t) r < len) {
+            return false;
+        }
+
+        if (demuxer->quickack) {
+            // Stop re-arming on error, it would fail every time
+            demuxer->quickack = net_set_quickack(demuxer->socket);
+        }
+    }
+
+    if (demuxer->dump_file
+            && fwrite(buf, 1, len, demuxer->dump_file) != len) {
+        LOGW("Demuxer '%s': could not write stream dump, dump disabled",
+             demuxer->name);
+        fclose(demuxer->dump_file);
+        demuxer->dump_file = NULL;
+    }
+
+    return true;
+}
+
+// Wait until the original time of the packet (if realtime), return false if
+// the replay has been interrupted
+static bool
+sc_demuxer_replay_wait(struct sc_demuxer *demuxer, int64_t pts) {
+    sc_mutex_lock(&demuxer->replay.mutex);
+
+    if (demuxer->replay.realtime && pts != AV_NOPTS_VALUE) {
+        if (!demuxer->replay.started) {
+            demuxer->replay.pts_origin = pts;
+            demuxer->replay.tick_origin = sc_tick_now();
+            demuxer->replay.started = true;
+        } else {
+            // The PTS are in microseconds, like sc_tick
+            sc_tick deadline = demuxer->replay.tick_origin
+                             + (pts - demuxer->replay.pts_origin);
+            bool timed_out = false;
+            while (!demuxer->replay.stopped && !timed_out) {
+                timed_out = !sc_cond_timedwait(&demuxer->replay.cond,
+                                               &demuxer->replay.mutex,
+                                               deadline);
+            }
+        }
     }
+
+    bool stopped = demuxer->replay.stopped;
+    sc_mutex_unlock(&demuxer->replay.mutex);
+
+    return !stopped;
 }
 
 static bool
 sc_demuxer_recv_codec_id(struct sc_demuxer *demuxer, uint32_t *codec_id) {
     uint8_t data[4];
-    ssize_t r = net_recv_all(demuxer->socket, data, 4);
-    if (r < 4) {
+    if (!sc_demuxer_recv(demuxer, data, 4)) {
         return false;
     }
 
@@ -70,8 +90,7 @@ static bool
 sc_demuxer_recv_video_size(struct sc_demuxer *demuxer, uint32_t *width,
                            uint32_t *height) {
     uint8_t data[8];
-    ssize_t r = net_recv_all(demuxer->socket, data, 8);
-    if (r < 8) {
+    if (!sc_demuxer_recv(demuxer, data, 8)) {
         return false;
     }
 
@@ -81,59 +100,42 @@ sc_demuxer_recv_video_size(struct sc_demuxer *demuxer, uint32_t *width,
 }
 
 static bool
-sc_demuxer_recv_packet(struct sc_demuxer *demuxer, AVPacket *packet) {
-    // The video and audio streams contain a sequence of raw packets (as
-    // provided by MediaCodec), each prefixed with a "meta" header.
-    //
-    // The "meta" header length is 12 bytes:
-    // [. . . . . . . .|. . . .]. . . . . . . . . . . . . . . ...
-    //  <-------------> <-----> <-----------------------------...
-    //        PTS        packet        raw packet
-    //                    size
-    //
-    // It is followed by <packet_size> bytes containing the packet/frame.
-    //
-    // The most significant bits of the PTS are used for packet flags:
-    //
-    //  byte 7   byte 6   byte 5   byte 4   byte 3   byte 2   byte 1   byte 0
-    // CK...... ........ ........ ........ ........ ........ ........ ........
-    // ^^<------------------------------------------------------------------->
-    // ||                                PTS
-    // | `- key frame
-    //  `-- config packet
-
+sc_demuxer_recv_packet(struct sc_demuxer *demuxer,
+                       struct sc_packet_pool *pool, size_t headroom,
+                       AVPacket *packet) {
+    // See packet_header.h for the format
     uint8_t header[SC_PACKET_HEADER_SIZE];
-    ssize_t r = net_recv_all(demuxer->socket, header, SC_PACKET_HEADER_SIZE);
-    if (r < SC_PACKET_HEADER_SIZE) {
+    if (!sc_demuxer_recv(demuxer, header, SC_PACKET_HEADER_SIZE)) {
         return false;
     }
 
-    uint64_t pts_flags = sc_read64be(header);
-    uint32_t len = sc_read32be(&header[8]);
+    uint64_t pts_flags;
+    uint32_t len = sc_packet_header_read(header, &pts_flags);
     assert(len);
 
-    if (av_new_packet(packet, len)) {
+    bool is_config = pts_flags & SC_PACKET_FLAG_CONFIG;
+    if (is_config) {
+        // Only media packets may receive a config packet in their headroom
+        headroom = 0;
+    }
+
+    if (!sc_packet_pool_new_packet(pool, packet, headroom, len)) {
         LOG_OOM();
         return false;
     }
 
-    r = net_recv_all(demuxer->socket, packet->data, len);
-    if (r < 0 || ((uint32_t) r) < len) {
+    if (!sc_demuxer_recv(demuxer, packet->data, len)) {
         av_packet_unref(packet);
         return false;
     }
 
-    if (pts_flags & SC_PACKET_FLAG_CONFIG) {
-        packet->pts = AV_NOPTS_VALUE;
-    } else {
-        packet->pts = pts_flags & SC_PACKET_PTS_MASK;
-    }
+    sc_packet_header_apply(packet, pts_flags);
 
-    if (pts_flags & SC_PACKET_FLAG_KEY_FRAME) {
-        packet->flags |= AV_PKT_FLAG_KEY;
+    if (demuxer->replay.file && !sc_demuxer_replay_wait(demuxer, packet->pts)) {
+        av_packet_unref(packet);
+        return false;
     }
 
-    packet->dts = packet->pts;
     return true;
 }
 
@@ -166,7 +168,7 @@ run_demuxer(void *data) {
         goto end;
     }
 
-    enum AVCodecID codec_id = sc_demuxer_to_avcodec_id(raw_codec_id);
+    enum AVCodecID codec_id = sc_packet_header_to_avcodec_id(raw_codec_id);
     if (codec_id == AV_CODEC_ID_NONE) {
         LOGE("Demuxer '%s': stream disabled due to unsupported codec",
              demuxer->name);
@@ -201,6 +203,8 @@ run_demuxer(void *data) {
         codec_ctx->width = width;
         codec_ctx->height = height;
         codec_ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+
+        sc_decoder_configure_threads(codec_ctx, demuxer->decoder_threads);
     } else {
         // Hardcoded audio properties
 #ifdef SCRCPY_LAVU_HAS_CHLAYOUT
@@ -222,6 +226,15 @@ run_demuxer(void *data) {
         goto finally_free_context;
     }
 
+    if (codec->type == AVMEDIA_TYPE_VIDEO) {
+        if (codec_ctx->active_thread_type & FF_THREAD_SLICE) {
+            LOGI("Demuxer '%s': slice-threaded decoding (%d threads)",
+                 demuxer->name, codec_ctx->thread_count);
+        } else {
+            LOGI("Demuxer '%s': single-threaded decoding", demuxer->name);
+        }
+    }
+
     if (!sc_packet_source_sinks_open(&demuxer->packet_source, codec_ctx)) {
         goto finally_free_context;
     }
@@ -237,14 +250,22 @@ run_demuxer(void *data) {
         sc_packet_merger_init(&merger);
     }
 
+    struct sc_packet_pool pool;
+    sc_packet_pool_init(&pool);
+
     AVPacket *packet = av_packet_alloc();
     if (!packet) {
         LOG_OOM();
-        goto finally_close_sinks;
+        goto finally_destroy_pool;
     }
 
     for (;;) {
-        bool ok = sc_demuxer_recv_packet(demuxer, packet);
+        // Receive the next media packet payload after some reserved space
+        // for the pending config packet, if any, so that merging it does not
+        // move the payload
+        size_t headroom = must_merge_config_packet
+                        ? sc_packet_merger_get_headroom(&merger) : 0;
+        bool ok = sc_demuxer_recv_packet(demuxer, &pool, headroom, packet);
         if (!ok) {
             // end of stream
             status = SC_DEMUXER_STATUS_EOS;
@@ -269,13 +290,17 @@ run_demuxer(void *data) {
     }
 
     LOGD("Demuxer '%s': end of frames", demuxer->name);
+    LOGD("Demuxer '%s': packet pool hits: %" PRIu64_ ", misses: %" PRIu64_,
+         demuxer->name, pool.hits, pool.misses);
 
     if (must_merge_config_packet) {
         sc_packet_merger_destroy(&merger);
     }
 
     av_packet_free(&packet);
-finally_close_sinks:
+finally_destroy_pool:
+    // The buffers still owned by the sinks are freed on their last unref
+    sc_packet_pool_destroy(&pool);
     sc_packet_source_sinks_close(&demuxer->packet_source);
 finally_free_context:
     // This also calls avcodec_close() internally
@@ -288,11 +313,16 @@ end:
 
 void
 sc_demuxer_init(struct sc_demuxer *demuxer, const char *name, sc_socket socket,
+                unsigned decoder_threads,
                 const struct sc_demuxer_callbacks *cbs, void *cbs_userdata) {
-    assert(socket != SC_SOCKET_NONE);
-
     demuxer->name = name; // statically allocated
     demuxer->socket = socket;
+    demuxer->quickack = false;
+    demuxer->decoder_threads = decoder_threads;
+    demuxer->dump_filename = NULL;
+    demuxer->dump_file = NULL;
+    demuxer->replay.filename = NULL;
+    demuxer->replay.file = NULL;
     sc_packet_source_init(&demuxer->packet_source);
 
     assert(cbs && cbs->on_ended);
@@ -301,20 +331,129 @@ sc_demuxer_init(struct sc_demuxer *demuxer, const char *name, sc_socket socket,
     demuxer->cbs_userdata = cbs_userdata;
 }
 
+void
+sc_demuxer_set_dump(struct sc_demuxer *demuxer, const char *filename) {
+    demuxer->dump_filename = filename;
+}
+
+void
+sc_demuxer_set_replay(struct sc_demuxer *demuxer, const char *filename,
+                      bool realtime) {
+    demuxer->replay.filename = filename;
+    demuxer->replay.realtime = realtime;
+}
+
+void
+sc_demuxer_set_quickack(struct sc_demuxer *demuxer) {
+    demuxer->quickack = true;
+}
+
+// Open "<filename>.<name>"
+static FILE *
+sc_demuxer_open_file(struct sc_demuxer *demuxer, const char *filename,
+                     const char *mode) {
+    size_t len = strlen(filename) + 1 + strlen(demuxer->name) + 1;
+    char *path = malloc(len);
+    if (!path) {
+        LOG_OOM();
+        return NULL;
+    }
+
+    snprintf(path, len, "%s.%s", filename, demuxer->name);
+
+    FILE *file = fopen(path, mode);
+    if (!file) {
+        LOGE("Demuxer '%s': could not open %s", demuxer->name, path);
+    }
+
+    free(path);
+    return file;
+}
+
+static void
+sc_demuxer_close_files(struct sc_demuxer *demuxer) {
+    if (demuxer->dump_file) {
+        fclose(demuxer->dump_file);
+        demuxer->dump_file = NULL;
+    }
+
+    if (demuxer->replay.file) {
+        sc_cond_destroy(&demuxer->replay.cond);
+        sc_mutex_destroy(&demuxer->replay.mutex);
+        fclose(demuxer->replay.file);
+        demuxer->replay.file = NULL;
+    }
+}
+
+static bool
+sc_demuxer_open_files(struct sc_demuxer *demuxer) {
+    // Either replay a file or receive from a socket
+    assert(!!demuxer->replay.filename == (demuxer->socket == SC_SOCKET_NONE));
+
+    if (demuxer->replay.filename) {
+        if (!sc_mutex_init(&demuxer->replay.mutex)) {
+            return false;
+        }
+
+        if (!sc_cond_init(&demuxer->replay.cond)) {
+            sc_mutex_destroy(&demuxer->replay.mutex);
+            return false;
+        }
+
+        demuxer->replay.file =
+            sc_demuxer_open_file(demuxer, demuxer->replay.filename, "rb");
+        if (!demuxer->replay.file) {
+            sc_cond_destroy(&demuxer->replay.cond);
+            sc_mutex_destroy(&demuxer->replay.mutex);
+            return false;
+        }
+
+        demuxer->replay.stopped = false;
+        demuxer->replay.started = false;
+    }
+
+    if (demuxer->dump_filename) {
+        demuxer->dump_file =
+            sc_demuxer_open_file(demuxer, demuxer->dump_filename, "wb");
+        if (!demuxer->dump_file) {
+            sc_demuxer_close_files(demuxer);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 sc_demuxer_start(struct sc_demuxer *demuxer) {
+    if (!sc_demuxer_open_files(demuxer)) {
+        return false;
+    }
+
     LOGD("Demuxer '%s': starting thread", demuxer->name);
 
     bool ok = sc_thread_create(&demuxer->thread, run_demuxer, "scrcpy-demuxer",
                                demuxer);
     if (!ok) {
         LOGE("Demuxer '%s': could not start thread", demuxer->name);
+        sc_demuxer_close_files(demuxer);
         return false;
     }
     return true;
 }
 
+void
+sc_demuxer_interrupt(struct sc_demuxer *demuxer) {
+    if (demuxer->replay.file) {
+        sc_mutex_lock(&demuxer->replay.mutex);
+        demuxer->replay.stopped = true;
+        sc_cond_signal(&demuxer->replay.cond);
+        sc_mutex_unlock(&demuxer->replay.mutex);
+    }
+}
+
 void
 sc_demuxer_join(struct sc_demuxer *demuxer) {
     sc_thread_join(&demuxer->thread, NULL);
+    sc_demuxer_close_files(demuxer);
 }
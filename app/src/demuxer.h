@@ -5,6 +5,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 
@@ -12,15 +13,41 @@
 #include "trait/packet_sink.h"
 #include "util/net.h"
 #include "util/thread.h"
+#include "util/tick.h"
 
 struct sc_demuxer {
     struct sc_packet_source packet_source; // packet source trait
 
     const char *name; // must be statically allocated (e.g. a string literal)
 
-    sc_socket socket;
+    sc_socket socket; // SC_SOCKET_NONE when replaying a stream file
+    // Re-arm TCP_QUICKACK after each receive
+    bool quickack;
     sc_thread thread;
 
+    // Slice threads for decoding video (0 for automatic)
+    unsigned decoder_threads;
+
+    // Write a copy of all the received bytes to "<dump_filename>.<name>"
+    const char *dump_filename; // NULL if disabled
+    FILE *dump_file;
+
+    // Read the stream from "<filename>.<name>" instead of the socket
+    struct {
+        const char *filename; // NULL if disabled
+        bool realtime; // respect the original pacing (from the PTS)
+        FILE *file;
+
+        // To interrupt the pacing wait
+        sc_mutex mutex;
+        sc_cond cond;
+        bool stopped;
+
+        bool started;
+        int64_t pts_origin;
+        sc_tick tick_origin;
+    } replay;
+
     const struct sc_demuxer_callbacks *cbs;
     void *cbs_userdata;
 };
@@ -37,13 +64,55 @@ struct sc_demuxer_callbacks {
 };
 
 // The name must be statically allocated (e.g. a string literal)
+//
+// The decoder_threads value is ignored for audio streams.
+//
+// The socket may be SC_SOCKET_NONE only if sc_demuxer_set_replay() is called.
 void
 sc_demuxer_init(struct sc_demuxer *demuxer, const char *name, sc_socket socket,
+                unsigned decoder_threads,
                 const struct sc_demuxer_callbacks *cbs, void *cbs_userdata);
 
+/**
+ * Dump the exact bytes received (codec id, video size, packets headers and
+ * payloads) to the file "<filename>.<name>"
+ *
+ * Must be called before sc_demuxer_start(). The filename must outlive the
+ * demuxer.
+ */
+void
+sc_demuxer_set_dump(struct sc_demuxer *demuxer, const char *filename);
+
+/**
+ * Read the stream from the file "<filename>.<name>" (as written by
+ * sc_demuxer_set_dump()) instead of the socket
+ *
+ * If realtime is true, packets are delivered at their original pace,
+ * according to their PTS. Otherwise, they are delivered as fast as possible.
+ *
+ * Must be called before sc_demuxer_start(). The filename must outlive the
+ * demuxer.
+ */
+void
+sc_demuxer_set_replay(struct sc_demuxer *demuxer, const char *filename,
+                      bool realtime);
+
+/**
+ * Re-arm TCP_QUICKACK on the socket after each receive, so that the device
+ * receives the ACKs without delay
+ *
+ * Must be called before sc_demuxer_start().
+ */
+void
+sc_demuxer_set_quickack(struct sc_demuxer *demuxer);
+
 bool
 sc_demuxer_start(struct sc_demuxer *demuxer);
 
+// Interrupt a replay (a socket is interrupted by shutting it down)
+void
+sc_demuxer_interrupt(struct sc_demuxer *demuxer);
+
 void
 sc_demuxer_join(struct sc_demuxer *demuxer);
 
@@ -1,11 +1,59 @@
 #include "display.h"
 
 #include <assert.h>
+#include <string.h>
+#include <libavutil/pixdesc.h>
 
 #include "util/log.h"
 
+// Not defined by old OpenGL headers
+#ifndef GL_PIXEL_UNPACK_BUFFER
+# define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif
+#ifndef GL_STREAM_DRAW
+# define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_MAP_WRITE_BIT
+# define GL_MAP_WRITE_BIT 0x0002
+#endif
+#ifndef GL_MAP_INVALIDATE_BUFFER_BIT
+# define GL_MAP_INVALIDATE_BUFFER_BIT 0x0008
+#endif
+#ifndef GL_MAP_UNSYNCHRONIZED_BIT
+# define GL_MAP_UNSYNCHRONIZED_BIT 0x0020
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+# define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+# define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_UNPACK_ROW_LENGTH
+# define GL_UNPACK_ROW_LENGTH 0x0CF2
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+# define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+# define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+# define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_WAIT_FAILED
+# define GL_WAIT_FAILED 0x911D
+#endif
+
+#if SDL_VERSION_ATLEAST(2, 0, 16)
+# define SC_DISPLAY_HAS_NV_TEXTURE // SDL_UpdateNVTexture()
+#endif
+
+// The GPU is expected to have consumed a buffer long before it is reused
+#define SC_DISPLAY_PBO_FENCE_TIMEOUT_NS UINT64_C(100000000) // 100 ms
+
 bool
-sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps) {
+sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps,
+                bool pbo) {
     display->renderer =
         SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
     if (!display->renderer) {
@@ -18,7 +66,21 @@ sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps) {
     const char *renderer_name = r ? NULL : renderer_info.name;
     LOGI("Renderer: %s", renderer_name ? renderer_name : "(unknown)");
 
+    display->texture = NULL;
+    display->texture_format = SDL_PIXELFORMAT_IYUV;
     display->mipmaps = false;
+    display->pbo.enabled = false;
+    display->pbo.persistent = false;
+    display->pbo.size = 0;
+    display->pbo.index = 0;
+    for (unsigned i = 0; i < SC_DISPLAY_PBO_COUNT; ++i) {
+        display->pbo.buffers[i] = 0;
+        display->pbo.mapped[i] = NULL;
+        display->pbo.fences[i] = NULL;
+    }
+
+    sc_histogram_reset(&display->upload.histogram);
+    display->upload.next_report = 0;
 
     // starts with "opengl"
     bool use_opengl = renderer_name && !strncmp(renderer_name, "opengl", 6);
@@ -58,6 +120,22 @@ sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps) {
         } else {
             LOGI("Trilinear filtering disabled");
         }
+
+        if (pbo) {
+            if (sc_opengl_has_pbo(gl)) {
+                display->pbo.enabled = true;
+                display->pbo.persistent = !gl->is_opengles
+                                       && gl->BufferStorage
+                                       && sc_opengl_version_at_least(gl, 4, 4,
+                                                                     0, 0);
+                LOGI("Texture uploads through pixel buffer objects (%s)",
+                     display->pbo.persistent ? "persistent mapping"
+                                             : "unsynchronized mapping");
+            } else {
+                LOGW("Pixel buffer objects disabled "
+                     "(OpenGL 3.2+ or ES 3.0+ required)");
+            }
+        }
     } else if (mipmaps) {
         LOGD("Trilinear filtering disabled (not an OpenGL renderer");
     }
@@ -68,11 +146,78 @@ sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps) {
     return true;
 }
 
+static void
+sc_display_pbo_free(struct sc_display *display) {
+    // The texture (and thus the renderer OpenGL context) must be bound
+    struct sc_opengl *gl = &display->gl;
+
+    for (unsigned i = 0; i < SC_DISPLAY_PBO_COUNT; ++i) {
+        if (display->pbo.fences[i]) {
+            gl->DeleteSync(display->pbo.fences[i]);
+            display->pbo.fences[i] = NULL;
+        }
+        if (display->pbo.mapped[i]) {
+            gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, display->pbo.buffers[i]);
+            gl->UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            display->pbo.mapped[i] = NULL;
+        }
+    }
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (display->pbo.size) {
+        gl->DeleteBuffers(SC_DISPLAY_PBO_COUNT, display->pbo.buffers);
+        display->pbo.size = 0;
+    }
+}
+
+static bool
+sc_display_pbo_alloc(struct sc_display *display, size_t size) {
+    // The texture (and thus the renderer OpenGL context) must be bound
+    struct sc_opengl *gl = &display->gl;
+
+    sc_display_pbo_free(display);
+
+    gl->GenBuffers(SC_DISPLAY_PBO_COUNT, display->pbo.buffers);
+    display->pbo.size = size;
+    display->pbo.index = 0;
+
+    bool ok = true;
+    for (unsigned i = 0; i < SC_DISPLAY_PBO_COUNT; ++i) {
+        gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, display->pbo.buffers[i]);
+        if (display->pbo.persistent) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+                             | GL_MAP_COHERENT_BIT;
+            gl->BufferStorage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags);
+            display->pbo.mapped[i] =
+                gl->MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+            if (!display->pbo.mapped[i]) {
+                ok = false;
+                break;
+            }
+        } else {
+            gl->BufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+        }
+    }
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    if (!ok) {
+        sc_display_pbo_free(display);
+    }
+
+    return ok;
+}
+
 void
 sc_display_destroy(struct sc_display *display) {
     if (display->pending.frame) {
         av_frame_free(&display->pending.frame);
     }
+    if (display->pbo.size && display->texture) {
+        // Otherwise, the buffers are released with the OpenGL context
+        SDL_GL_BindTexture(display->texture, NULL, NULL);
+        sc_display_pbo_free(display);
+        SDL_GL_UnbindTexture(display->texture);
+    }
 #ifdef SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
     SDL_GL_DeleteContext(display->gl_context);
 #endif
@@ -82,11 +227,30 @@ sc_display_destroy(struct sc_display *display) {
     SDL_DestroyRenderer(display->renderer);
 }
 
+// Return the texture format to upload frames directly (without conversion),
+// or 0 if the frame format is not supported
+static uint32_t
+sc_display_get_texture_format(enum AVPixelFormat format) {
+    switch (format) {
+        case AV_PIX_FMT_YUV420P:
+        case AV_PIX_FMT_YUVJ420P: // same layout, full range
+            return SDL_PIXELFORMAT_IYUV;
+#ifdef SC_DISPLAY_HAS_NV_TEXTURE
+        case AV_PIX_FMT_NV12:
+            return SDL_PIXELFORMAT_NV12;
+        case AV_PIX_FMT_NV21:
+            return SDL_PIXELFORMAT_NV21;
+#endif
+        default:
+            return 0;
+    }
+}
+
 static SDL_Texture *
 sc_display_create_texture(struct sc_display *display,
                           struct sc_size size) {
     SDL_Renderer *renderer = display->renderer;
-    SDL_Texture *texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_YV12,
+    SDL_Texture *texture = SDL_CreateTexture(renderer, display->texture_format,
                                              SDL_TEXTUREACCESS_STREAMING,
                                              size.width, size.height);
     if (!texture) {
@@ -138,13 +302,21 @@ sc_display_set_pending_frame(struct sc_display *display, const AVFrame *frame) {
     return true;
 }
 
+static bool
+sc_display_set_texture_size_internal(struct sc_display *display,
+                                     struct sc_size size);
+
+static bool
+sc_display_update_texture_internal(struct sc_display *display,
+                                   const AVFrame *frame);
+
 static bool
 sc_display_apply_pending(struct sc_display *display) {
     if (display->pending.flags & SC_DISPLAY_PENDING_FLAG_SIZE) {
         assert(!display->texture);
-        display->texture =
-            sc_display_create_texture(display, display->pending.size);
-        if (!display->texture) {
+        bool ok = sc_display_set_texture_size_internal(display,
+                                                       display->pending.size);
+        if (!ok) {
             return false;
         }
 
@@ -153,7 +325,8 @@ sc_display_apply_pending(struct sc_display *display) {
 
     if (display->pending.flags & SC_DISPLAY_PENDING_FLAG_FRAME) {
         assert(display->pending.frame);
-        bool ok = sc_display_update_texture(display, display->pending.frame);
+        bool ok = sc_display_update_texture_internal(display,
+                                                     display->pending.frame);
         if (!ok) {
             return false;
         }
@@ -174,12 +347,14 @@ sc_display_set_texture_size_internal(struct sc_display *display,
         SDL_DestroyTexture(display->texture);
     }
 
+    display->texture_size = size;
     display->texture = sc_display_create_texture(display, size);
     if (!display->texture) {
         return false;
     }
 
-    LOGI("Texture: %" PRIu16 "x%" PRIu16, size.width, size.height);
+    LOGI("Texture: %" PRIu16 "x%" PRIu16 " (%s)", size.width, size.height,
+         SDL_GetPixelFormatName(display->texture_format));
     return true;
 }
 
@@ -195,16 +370,178 @@ sc_display_set_texture_size(struct sc_display *display, struct sc_size size) {
     return SC_DISPLAY_RESULT_OK;
 }
 
+static void
+sc_display_pbo_wait(struct sc_display *display, unsigned index) {
+    struct sc_opengl *gl = &display->gl;
+
+    GLsync fence = display->pbo.fences[index];
+    if (!fence) {
+        return;
+    }
+
+    GLenum ret = gl->ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                    SC_DISPLAY_PBO_FENCE_TIMEOUT_NS);
+    if (ret == GL_TIMEOUT_EXPIRED || ret == GL_WAIT_FAILED) {
+        // Overwrite it anyway, at worst a frame is partially updated
+        LOGD("Pixel buffer object still in use");
+    }
+
+    gl->DeleteSync(fence);
+    display->pbo.fences[index] = NULL;
+}
+
+// Upload the frame through the next pixel buffer object: the frame is copied
+// to the mapped buffer, then the texture is updated asynchronously from it by
+// the driver (without a blocking copy from client memory).
+//
+// The texture must be bound. Return false to fallback to SDL_UpdateYUVTexture.
+static bool
+sc_display_update_texture_pbo(struct sc_display *display,
+                              const AVFrame *frame) {
+    struct sc_opengl *gl = &display->gl;
+
+    // Same layout as the SDL IYUV texture: one GL_LUMINANCE texture per plane
+    // (Y on texture unit 0, U on unit 1, V on unit 2)
+    int widths[3] = {frame->width, (frame->width + 1) / 2,
+                     (frame->width + 1) / 2};
+    int heights[3] = {frame->height, (frame->height + 1) / 2,
+                      (frame->height + 1) / 2};
+
+    // The planes are copied with their padding, so that each plane is copied
+    // with a single memcpy(). The padding after the last row is not copied:
+    // for a cropped frame (--render-roi), data[i] points inside a larger
+    // picture, so the last row may end at the end of the buffer.
+    size_t offsets[3];
+    size_t sizes[3];
+    size_t size = 0;
+    for (unsigned i = 0; i < 3; ++i) {
+        if (frame->linesize[i] < widths[i]) {
+            // e.g. negative linesize
+            return false;
+        }
+        offsets[i] = size;
+        sizes[i] = (size_t) frame->linesize[i] * (heights[i] - 1) + widths[i];
+        size += sizes[i];
+    }
+
+    if (size > display->pbo.size) {
+        bool ok = sc_display_pbo_alloc(display, size);
+        if (!ok) {
+            LOGW("Could not map pixel buffer object, disabling");
+            display->pbo.enabled = false;
+            return false;
+        }
+    }
+
+    unsigned index = display->pbo.index;
+    sc_display_pbo_wait(display, index);
+
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, display->pbo.buffers[index]);
+
+    uint8_t *data;
+    if (display->pbo.persistent) {
+        data = display->pbo.mapped[index];
+    } else {
+        // The fence guarantees that the GPU does not read the buffer anymore
+        GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+                          | GL_MAP_UNSYNCHRONIZED_BIT;
+        data = gl->MapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, access);
+        if (!data) {
+            gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            LOGW("Could not map pixel buffer object, disabling");
+            display->pbo.enabled = false;
+            return false;
+        }
+    }
+
+    for (unsigned i = 0; i < 3; ++i) {
+        memcpy(data + offsets[i], frame->data[i], sizes[i]);
+    }
+
+    if (!display->pbo.persistent) {
+        gl->UnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    }
+
+    gl->PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (unsigned i = 0; i < 3; ++i) {
+        gl->ActiveTexture(GL_TEXTURE0 + i);
+        gl->PixelStorei(GL_UNPACK_ROW_LENGTH, frame->linesize[i]);
+        // With a pixel unpack buffer bound, the pointer is an offset
+        gl->TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, widths[i], heights[i],
+                          GL_LUMINANCE, GL_UNSIGNED_BYTE,
+                          (const void *) (uintptr_t) offsets[i]);
+    }
+
+    // Restore the state expected by the SDL renderer
+    gl->PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    gl->ActiveTexture(GL_TEXTURE0);
+    gl->BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    display->pbo.fences[index] =
+        gl->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    display->pbo.index = (index + 1) % SC_DISPLAY_PBO_COUNT;
+
+    return true;
+}
+
+static void
+sc_display_report_upload(struct sc_display *display, sc_tick now) {
+    struct sc_histogram *h = &display->upload.histogram;
+    if (h->count) {
+        LOGD("Texture upload (us): p50=%" PRItick " p99=%" PRItick
+             " max=%" PRItick " (%" PRIu64_ " frames)",
+             sc_histogram_percentile(h, 50), sc_histogram_percentile(h, 99),
+             h->max, h->count);
+    }
+
+    sc_histogram_reset(h);
+    display->upload.next_report = now + SC_DISPLAY_UPLOAD_REPORT_INTERVAL;
+}
+
 static bool
 sc_display_update_texture_internal(struct sc_display *display,
                                    const AVFrame *frame) {
-    int ret = SDL_UpdateYUVTexture(display->texture, NULL,
-                                   frame->data[0], frame->linesize[0],
-                                   frame->data[1], frame->linesize[1],
-                                   frame->data[2], frame->linesize[2]);
-    if (ret) {
-        LOGD("Could not update texture: %s", SDL_GetError());
-        return false;
+    uint32_t format = sc_display_get_texture_format(frame->format);
+    assert(format);
+    if (format != display->texture_format || !display->texture) {
+        // Recreate the texture to upload the frame planes as is
+        display->texture_format = format;
+        bool ok = sc_display_set_texture_size_internal(display,
+                                                       display->texture_size);
+        if (!ok) {
+            return false;
+        }
+    }
+
+    sc_tick start = sc_tick_now();
+
+    bool uploaded = false;
+    if (display->pbo.enabled && format == SDL_PIXELFORMAT_IYUV) {
+        SDL_GL_BindTexture(display->texture, NULL, NULL);
+        uploaded = sc_display_update_texture_pbo(display, frame);
+        SDL_GL_UnbindTexture(display->texture);
+    }
+
+    if (!uploaded) {
+        int ret;
+#ifdef SC_DISPLAY_HAS_NV_TEXTURE
+        if (format != SDL_PIXELFORMAT_IYUV) {
+            // Interleaved chroma plane, uploaded as a single texture
+            ret = SDL_UpdateNVTexture(display->texture, NULL,
+                                      frame->data[0], frame->linesize[0],
+                                      frame->data[1], frame->linesize[1]);
+        } else
+#endif
+        {
+            ret = SDL_UpdateYUVTexture(display->texture, NULL,
+                                       frame->data[0], frame->linesize[0],
+                                       frame->data[1], frame->linesize[1],
+                                       frame->data[2], frame->linesize[2]);
+        }
+        if (ret) {
+            LOGD("Could not update texture: %s", SDL_GetError());
+            return false;
+        }
     }
 
     if (display->mipmaps) {
@@ -213,11 +550,23 @@ sc_display_update_texture_internal(struct sc_display *display,
         SDL_GL_UnbindTexture(display->texture);
     }
 
+    sc_tick now = sc_tick_now();
+    sc_histogram_add(&display->upload.histogram, now - start);
+    if (now >= display->upload.next_report) {
+        sc_display_report_upload(display, now);
+    }
+
     return true;
 }
 
 enum sc_display_result
 sc_display_update_texture(struct sc_display *display, const AVFrame *frame) {
+    if (!sc_display_get_texture_format(frame->format)) {
+        LOGE("Unsupported frame format: %s",
+             av_get_pix_fmt_name(frame->format));
+        return SC_DISPLAY_RESULT_ERROR;
+    }
+
     bool ok = sc_display_update_texture_internal(display, frame);
     if (!ok) {
         ok = sc_display_set_pending_frame(display, frame);
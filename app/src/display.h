@@ -10,14 +10,25 @@
 #include "coords.h"
 #include "opengl.h"
 #include "options.h"
+#include "util/histogram.h"
+#include "util/tick.h"
 
 #ifdef __APPLE__
 # define SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
 #endif
 
+// Number of pixel buffer objects used in turn to upload frames, so that
+// writing a frame never waits for the upload of the previous one
+#define SC_DISPLAY_PBO_COUNT 3
+
+#define SC_DISPLAY_UPLOAD_REPORT_INTERVAL SC_TICK_FROM_SEC(10)
+
 struct sc_display {
     SDL_Renderer *renderer;
     SDL_Texture *texture;
+    struct sc_size texture_size;
+    // SDL_PIXELFORMAT_IYUV, or NV12/NV21 if the decoder outputs them
+    uint32_t texture_format;
 
     struct sc_opengl gl;
 #ifdef SC_DISPLAY_FORCE_OPENGL_CORE_PROFILE
@@ -26,6 +37,23 @@ struct sc_display {
 
     bool mipmaps;
 
+    // Streaming texture uploads through pixel buffer objects
+    struct {
+        bool enabled;
+        bool persistent; // mapped once (OpenGL 4.4+)
+        GLuint buffers[SC_DISPLAY_PBO_COUNT];
+        uint8_t *mapped[SC_DISPLAY_PBO_COUNT]; // only if persistent
+        GLsync fences[SC_DISPLAY_PBO_COUNT];
+        size_t size; // size of each buffer, 0 if not allocated
+        unsigned index; // next buffer to write
+    } pbo;
+
+    // Texture upload duration (including mipmaps generation)
+    struct {
+        struct sc_histogram histogram;
+        sc_tick next_report;
+    } upload;
+
     struct {
 #define SC_DISPLAY_PENDING_FLAG_SIZE 1
 #define SC_DISPLAY_PENDING_FLAG_FRAME 2
@@ -42,7 +70,8 @@ enum sc_display_result {
 };
 
 bool
-sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps);
+sc_display_init(struct sc_display *display, SDL_Window *window, bool mipmaps,
+                bool pbo);
 
 void
 sc_display_destroy(struct sc_display *display);
@@ -21,6 +21,8 @@ sc_fps_counter_init(struct sc_fps_counter *counter) {
 
     counter->thread_started = false;
     atomic_init(&counter->started, 0);
+    counter->report = NULL;
+    counter->report_userdata = NULL;
     // no need to initialize the other fields, they are unused until started
 
     return true;
@@ -53,6 +55,10 @@ display_fps(struct sc_fps_counter *counter) {
     } else {
         LOGI("%u fps", rendered_per_second);
     }
+
+    if (counter->report) {
+        counter->report(counter->report_userdata);
+    }
 }
 
 // must be called with mutex locked
@@ -158,6 +164,14 @@ sc_fps_counter_join(struct sc_fps_counter *counter) {
     }
 }
 
+void
+sc_fps_counter_set_reporter(struct sc_fps_counter *counter,
+                            void (*report)(void *userdata), void *userdata) {
+    assert(!counter->thread_started);
+    counter->report = report;
+    counter->report_userdata = userdata;
+}
+
 void
 sc_fps_counter_add_rendered_frame(struct sc_fps_counter *counter) {
     if (!is_started(counter)) {
@@ -25,6 +25,11 @@ struct sc_fps_counter {
     unsigned nr_rendered;
     unsigned nr_skipped;
     sc_tick next_timestamp;
+
+    // optional, called (with the mutex locked) every time the fps is printed,
+    // to print other statistics at the same rate
+    void (*report)(void *userdata);
+    void *report_userdata;
 };
 
 bool
@@ -50,6 +55,11 @@ sc_fps_counter_interrupt(struct sc_fps_counter *counter);
 void
 sc_fps_counter_join(struct sc_fps_counter *counter);
 
+// must be called before sc_fps_counter_start()
+void
+sc_fps_counter_set_reporter(struct sc_fps_counter *counter,
+                            void (*report)(void *userdata), void *userdata);
+
 void
 sc_fps_counter_add_rendered_frame(struct sc_fps_counter *counter);
 
@@ -6,39 +6,77 @@
 
 #include "util/log.h"
 
+// Flag set in triple.ready when the shared frame has not been consumed
+#define SC_FRAME_BUFFER_FRESH 0x4
+
+static inline bool
+is_triple(const struct sc_frame_buffer *fb) {
+    return fb->capacity == 1;
+}
+
+static inline unsigned
+get_frame_count(const struct sc_frame_buffer *fb) {
+    return is_triple(fb) ? 3 : fb->capacity;
+}
+
+static void
+free_frames(struct sc_frame_buffer *fb, unsigned count) {
+    for (unsigned i = 0; i < count; ++i) {
+        av_frame_free(&fb->frames[i]);
+    }
+}
+
 bool
-sc_frame_buffer_init(struct sc_frame_buffer *fb) {
-    fb->pending_frame = av_frame_alloc();
-    if (!fb->pending_frame) {
-        LOG_OOM();
-        return false;
+sc_frame_buffer_init(struct sc_frame_buffer *fb, unsigned capacity) {
+    assert(capacity && capacity <= SC_FRAME_BUFFER_MAX_FRAMES);
+    fb->capacity = capacity;
+
+    unsigned count = get_frame_count(fb);
+    for (unsigned i = 0; i < count; ++i) {
+        fb->frames[i] = av_frame_alloc();
+        if (!fb->frames[i]) {
+            LOG_OOM();
+            free_frames(fb, i);
+            return false;
+        }
+    }
+
+    if (is_triple(fb)) {
+        fb->triple.back = 0;
+        fb->triple.front = 1;
+        // there is initially no frame, so the shared frame is not fresh
+        atomic_init(&fb->triple.ready, 2);
+        return true;
     }
 
     fb->tmp_frame = av_frame_alloc();
     if (!fb->tmp_frame) {
         LOG_OOM();
-        av_frame_free(&fb->pending_frame);
+        free_frames(fb, count);
         return false;
     }
 
     bool ok = sc_mutex_init(&fb->mutex);
     if (!ok) {
-        av_frame_free(&fb->pending_frame);
+        free_frames(fb, count);
         av_frame_free(&fb->tmp_frame);
         return false;
     }
 
-    // there is initially no frame, so consider it has already been consumed
-    fb->pending_frame_consumed = true;
+    fb->head = 0;
+    // there is initially no frame
+    fb->count = 0;
 
     return true;
 }
 
 void
 sc_frame_buffer_destroy(struct sc_frame_buffer *fb) {
-    sc_mutex_destroy(&fb->mutex);
-    av_frame_free(&fb->pending_frame);
-    av_frame_free(&fb->tmp_frame);
+    if (!is_triple(fb)) {
+        sc_mutex_destroy(&fb->mutex);
+        av_frame_free(&fb->tmp_frame);
+    }
+    free_frames(fb, get_frame_count(fb));
 }
 
 static inline void
@@ -48,10 +86,58 @@ swap_frames(AVFrame **lhs, AVFrame **rhs) {
     *rhs = tmp;
 }
 
+static bool
+sc_frame_buffer_triple_push(struct sc_frame_buffer *fb, const AVFrame *frame,
+                            bool *skipped) {
+    // The back frame is always empty here
+    AVFrame *back = fb->frames[fb->triple.back];
+    int r = av_frame_ref(back, frame);
+    if (r) {
+        LOGE("Could not ref frame: %d", r);
+        return false;
+    }
+
+    // Publish the new frame and take the previous shared frame
+    unsigned ready = fb->triple.back | SC_FRAME_BUFFER_FRESH;
+    unsigned prev = atomic_exchange_explicit(&fb->triple.ready, ready,
+                                             memory_order_acq_rel);
+    fb->triple.back = prev & ~SC_FRAME_BUFFER_FRESH;
+
+    bool fresh = prev & SC_FRAME_BUFFER_FRESH;
+    if (fresh) {
+        // The previous frame has never been consumed
+        av_frame_unref(fb->frames[fb->triple.back]);
+    }
+
+    if (skipped) {
+        *skipped = fresh;
+    }
+
+    return true;
+}
+
+static void
+sc_frame_buffer_triple_consume(struct sc_frame_buffer *fb, AVFrame *dst) {
+    // Give back the (empty) front frame and take the shared frame
+    unsigned prev = atomic_exchange_explicit(&fb->triple.ready,
+                                             fb->triple.front,
+                                             memory_order_acq_rel);
+    assert(prev & SC_FRAME_BUFFER_FRESH);
+    fb->triple.front = prev & ~SC_FRAME_BUFFER_FRESH;
+
+    av_frame_move_ref(dst, fb->frames[fb->triple.front]);
+    // av_frame_move_ref() resets its source frame, so no need to call
+    // av_frame_unref()
+}
+
 bool
 sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
-                     bool *previous_frame_skipped) {
-    // Use a temporary frame to preserve pending_frame in case of error.
+                     bool *skipped) {
+    if (is_triple(fb)) {
+        return sc_frame_buffer_triple_push(fb, frame, skipped);
+    }
+
+    // Use a temporary frame to preserve the pending frames in case of error.
     // tmp_frame is an empty frame, no need to call av_frame_unref() beforehand.
     int r = av_frame_ref(fb->tmp_frame, frame);
     if (r) {
@@ -61,15 +147,23 @@ sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
 
     sc_mutex_lock(&fb->mutex);
 
-    // Now that av_frame_ref() succeeded, we can replace the previous
-    // pending_frame
-    swap_frames(&fb->pending_frame, &fb->tmp_frame);
-    av_frame_unref(fb->tmp_frame);
+    bool full = fb->count == fb->capacity;
+    if (full) {
+        // Drop the oldest pending frame
+        av_frame_unref(fb->frames[fb->head]);
+        fb->head = (fb->head + 1) % fb->capacity;
+        --fb->count;
+    }
+
+    // Now that av_frame_ref() succeeded, we can store the new frame in the
+    // free slot (which is empty)
+    unsigned index = (fb->head + fb->count) % fb->capacity;
+    swap_frames(&fb->frames[index], &fb->tmp_frame);
+    ++fb->count;
 
-    if (previous_frame_skipped) {
-        *previous_frame_skipped = !fb->pending_frame_consumed;
+    if (skipped) {
+        *skipped = full;
     }
-    fb->pending_frame_consumed = false;
 
     sc_mutex_unlock(&fb->mutex);
 
@@ -78,13 +172,35 @@ sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
 
 void
 sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst) {
+    if (is_triple(fb)) {
+        sc_frame_buffer_triple_consume(fb, dst);
+        return;
+    }
+
     sc_mutex_lock(&fb->mutex);
-    assert(!fb->pending_frame_consumed);
-    fb->pending_frame_consumed = true;
+    assert(fb->count);
 
-    av_frame_move_ref(dst, fb->pending_frame);
+    av_frame_move_ref(dst, fb->frames[fb->head]);
     // av_frame_move_ref() resets its source frame, so no need to call
     // av_frame_unref()
 
+    fb->head = (fb->head + 1) % fb->capacity;
+    --fb->count;
+
     sc_mutex_unlock(&fb->mutex);
 }
+
+bool
+sc_frame_buffer_has_pending(struct sc_frame_buffer *fb) {
+    if (is_triple(fb)) {
+        unsigned ready = atomic_load_explicit(&fb->triple.ready,
+                                              memory_order_relaxed);
+        return ready & SC_FRAME_BUFFER_FRESH;
+    }
+
+    sc_mutex_lock(&fb->mutex);
+    bool pending = fb->count;
+    sc_mutex_unlock(&fb->mutex);
+
+    return pending;
+}
@@ -3,6 +3,7 @@
 
 #include "common.h"
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
 #include "util/thread.h"
@@ -10,35 +11,67 @@
 // forward declarations
 typedef struct AVFrame AVFrame;
 
+#define SC_FRAME_BUFFER_MAX_FRAMES 16
+
 /**
- * A frame buffer holds 1 pending frame, which is the last frame received from
- * the producer (typically, the decoder).
+ * A frame buffer holds up to `capacity` pending frames, which are the last
+ * frames received from the producer (typically, the decoder).
+ *
+ * If the buffer is full when the producer pushes a new frame, then the oldest
+ * pending frame is lost.
+ *
+ * With a capacity of 1, the intent is to always provide access to the very
+ * last frame to minimize latency. A larger capacity absorbs irregularities
+ * of the consumer, at the cost of latency.
  *
- * If a pending frame has not been consumed when the producer pushes a new
- * frame, then it is lost. The intent is to always provide access to the very
- * last frame to minimize latency.
+ * There must be a single producer thread and a single consumer thread.
  */
 
 struct sc_frame_buffer {
-    AVFrame *pending_frame;
-    AVFrame *tmp_frame; // To preserve the pending frame on error
+    unsigned capacity;
 
+    // capacity == 1: lock-free triple buffer in frames[0..2]
+    //
+    // The producer owns frames[back] and the consumer owns frames[front]. The
+    // third frame is exchanged atomically through `ready`, which also holds
+    // SC_FRAME_BUFFER_FRESH if it has not been consumed yet.
+    struct {
+        unsigned back;
+        unsigned front;
+        atomic_uint ready;
+    } triple;
+
+    // capacity > 1: ring buffer protected by the mutex
+    AVFrame *tmp_frame; // To preserve the pending frames on error
     sc_mutex mutex;
+    unsigned head; // index of the oldest pending frame
+    unsigned count; // number of pending frames
 
-    bool pending_frame_consumed;
+    AVFrame *frames[SC_FRAME_BUFFER_MAX_FRAMES];
 };
 
 bool
-sc_frame_buffer_init(struct sc_frame_buffer *fb);
+sc_frame_buffer_init(struct sc_frame_buffer *fb, unsigned capacity);
 
 void
 sc_frame_buffer_destroy(struct sc_frame_buffer *fb);
 
+/**
+ * Push a new frame
+ *
+ * If the buffer was full, the oldest pending frame is dropped and *skipped is
+ * set to true.
+ */
 bool
 sc_frame_buffer_push(struct sc_frame_buffer *fb, const AVFrame *frame,
                      bool *skipped);
 
+// Move the oldest pending frame to dst (there must be one)
 void
 sc_frame_buffer_consume(struct sc_frame_buffer *fb, AVFrame *dst);
 
+// Return true if there is at least one pending frame
+bool
+sc_frame_buffer_has_pending(struct sc_frame_buffer *fb);
+
 #endif
@@ -9,6 +9,7 @@
 #include <SDL2/SDL_events.h>
 
 #include "coords.h"
+#include "util/tick.h"
 
 /* The representation of input events in scrcpy is very close to the SDL API,
  * for simplicity.
@@ -377,6 +378,9 @@ struct sc_touch_event {
     enum sc_touch_action action;
     uint64_t pointer_id;
     float pressure;
+    // Host time of the input event which generated the touch, to measure
+    // the input latency (0 if unknown)
+    sc_tick timestamp;
 };
 
 static inline uint16_t
@@ -9,6 +9,9 @@
 
 #define SC_SDL_SHORTCUT_MODS_MASK (KMOD_CTRL | KMOD_ALT | KMOD_GUI)
 
+// 输入事件队列的初始容量，需要时会扩容
+#define SC_INPUT_EVENT_QUEUE_INIT 64
+
 static void
 sc_input_manager_process_touch(struct sc_input_manager *im,
                                const SDL_TouchFingerEvent *event);
@@ -63,7 +66,7 @@ is_shortcut_mod(struct sc_input_manager *im, uint16_t sdl_mod)
     return false;
 }
 
-void sc_input_manager_init(struct sc_input_manager *im,
+bool sc_input_manager_init(struct sc_input_manager *im,
                            const struct sc_input_manager_params *params)
 {
     assert(!params->controller || (params->kp && params->kp->ops));
@@ -93,11 +96,50 @@ void sc_input_manager_init(struct sc_input_manager *im,
 
     im->vfinger_down = false;
 
+    im->aim_coalesce.dx = 0;
+    im->aim_coalesce.dy = 0;
+    im->aim_coalesce.interval = 0;
+    im->aim_coalesce.next_flush = 0;
+    im->aim_coalesce.pending = false;
+    im->aim_coalesce.timestamp = 0;
+
+    im->geometry.frame_size.width = 0;
+    im->geometry.frame_size.height = 0;
+    im->geometry.orientation = SC_ORIENTATION_0;
+    im->timestamp = 0;
+
     im->last_keycode = SDLK_UNKNOWN;
     im->last_mod = 0;
     im->key_repeat = 0;
 
     im->next_sequence = 1; // 0 is reserved for SC_SEQUENCE_INVALID
+
+    sc_vecdeque_init(&im->queue);
+    bool ok = sc_vecdeque_reserve(&im->queue, SC_INPUT_EVENT_QUEUE_INIT);
+    if (!ok)
+    {
+        LOG_OOM();
+        return false;
+    }
+
+    ok = sc_mutex_init(&im->mutex);
+    if (!ok)
+    {
+        sc_vecdeque_destroy(&im->queue);
+        return false;
+    }
+
+    ok = sc_cond_init(&im->cond);
+    if (!ok)
+    {
+        sc_mutex_destroy(&im->mutex);
+        sc_vecdeque_destroy(&im->queue);
+        return false;
+    }
+
+    im->stopped = false;
+
+    return true;
 }
 
 static void
@@ -419,67 +461,159 @@ sc_input_manager_send_touch_event(struct sc_input_manager *im,
                  Uint32 type,
                  SDL_FingerID fingerId)
 {
-    int32_t w = im->screen->content_size.width;
-    int32_t h = im->screen->content_size.height;
-    enum sc_orientation orientation = im->screen->orientation;
-    struct sc_point result;
-
-    int32_t x = ix * w;
-    int32_t y = iy * h;
-
-    switch (orientation) {
-        case SC_ORIENTATION_0:
-            result.x = x;
-            result.y = y;
-            break;
-        case SC_ORIENTATION_90:
-            result.x = y;
-            result.y = w - x;
-            break;
-        case SC_ORIENTATION_180:
-            result.x = w - x;
-            result.y = h - y;
-            break;
-        case SC_ORIENTATION_270:
-            result.x = h - y;
-            result.y = x;
-            break;
-        case SC_ORIENTATION_FLIP_0:
-            result.x = w - x;
-            result.y = y;
-            break;
-        case SC_ORIENTATION_FLIP_90:
-            result.x = h - y;
-            result.y = w - x;
-            break;
-        case SC_ORIENTATION_FLIP_180:
-            result.x = x;
-            result.y = h - y;
-            break;
-        default:
-            assert(orientation == SC_ORIENTATION_FLIP_270);
-            result.x = y;
-            result.y = x;
-            break;
-    }
+    // 在输入线程中调用，使用事件携带的几何信息快照
+    const struct sc_input_geometry *geometry = &im->geometry;
+    struct sc_point result =
+        sc_fpsgame_keys_to_frame_point(geometry->frame_size,
+                                       geometry->orientation, ix, iy);
 
     struct sc_touch_event evt = {
         .position = {
-            .screen_size = im->screen->frame_size,
+            .screen_size = geometry->frame_size,
             .point = result,
         },
         .action = sc_touch_action_from_sdl(type),
         .pointer_id = fingerId,
         .pressure = (rand() % 300 + 700) / 1000.0,
+        .timestamp = im->timestamp,
     };
 
     im->mp->ops->process_touch(im->mp, &evt);
 }
 
+// 方向轮盘：按下的方向键之和决定手指的位置
+static void
+sc_input_manager_process_joystick(struct sc_input_manager *im,
+                                  const struct sc_fpsgame_binding *binding,
+                                  bool down)
+{
+    struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+    bool was_active = sfk->rouletteX || sfk->rouletteY;
+    int sign = down ? 1 : -1;
+    sfk->rouletteX += sign * binding->axis_x;
+    sfk->rouletteY += sign * binding->axis_y;
+    bool active = sfk->rouletteX || sfk->rouletteY;
+
+    float cx = sfk->wheelCenterposX;
+    float cy = sfk->wheelCenterposY;
+    if (!active)
+    {
+        if (was_active)
+        {
+            sc_input_manager_send_touch_event(im, cx, cy, SDL_FINGERUP,
+                                              binding->pointer_id);
+        }
+        return;
+    }
+
+    float x = cx;
+    float y = cy;
+    if (sfk->rouletteX < 0)
+    {
+        x -= sfk->wheelLeftOffset;
+    }
+    else if (sfk->rouletteX > 0)
+    {
+        x += sfk->wheelRightOffset;
+    }
+    if (sfk->rouletteY < 0)
+    {
+        y -= sfk->wheelUpOffset;
+    }
+    else if (sfk->rouletteY > 0)
+    {
+        y += sfk->wheeldownOffset;
+    }
+
+    if (!was_active)
+    {
+        sc_input_manager_send_touch_event(im, cx, cy, SDL_FINGERDOWN,
+                                          binding->pointer_id);
+    }
+    sc_input_manager_send_touch_event(im, x, y, SDL_FINGERMOTION,
+                                      binding->pointer_id);
+}
+
+// 开镜按键按下期间使用开镜灵敏度
+static inline void
+sc_input_manager_update_ads(struct sc_input_manager *im,
+                            const struct sc_fpsgame_binding *binding,
+                            bool pressed)
+{
+    struct sc_fpsgame_aim *aim = &im->fpsgame_keys->aim;
+    if (binding->pointer_id == aim->ads_pointer_id)
+    {
+        aim->ads = pressed;
+    }
+}
+
+// 执行一个按键绑定（按键表和鼠标按键表共用）
+static void
+sc_input_manager_process_fpsgame_binding(struct sc_input_manager *im,
+                                         struct sc_fpsgame_binding *binding,
+                                         bool down)
+{
+    switch (binding->action)
+    {
+    case SC_FPSGAME_ACTION_HOLD:
+        sc_input_manager_update_ads(im, binding, down);
+        sc_input_manager_send_touch_event(im, binding->x, binding->y,
+                                          down ? SDL_FINGERDOWN : SDL_FINGERUP,
+                                          binding->pointer_id);
+        return;
+    case SC_FPSGAME_ACTION_TAP:
+        if (down)
+        {
+            sc_input_manager_send_touch_event(im, binding->x, binding->y,
+                                              SDL_FINGERDOWN,
+                                              binding->pointer_id);
+            sc_input_manager_send_touch_event(im, binding->x, binding->y,
+                                              SDL_FINGERUP,
+                                              binding->pointer_id);
+        }
+        return;
+    case SC_FPSGAME_ACTION_TOGGLE:
+        if (down)
+        {
+            binding->toggled = !binding->toggled;
+            sc_input_manager_update_ads(im, binding, binding->toggled);
+            sc_input_manager_send_touch_event(im, binding->x, binding->y,
+                                              binding->toggled ? SDL_FINGERDOWN
+                                                               : SDL_FINGERUP,
+                                              binding->pointer_id);
+        }
+        return;
+    case SC_FPSGAME_ACTION_JOYSTICK:
+        sc_input_manager_process_joystick(im, binding, down);
+        return;
+    default:
+        assert(binding->action == SC_FPSGAME_ACTION_NONE);
+        return;
+    }
+}
+
+// 捕获鼠标时的按键，在输入线程中执行
+static void
+sc_input_manager_process_fpsgame_key(struct sc_input_manager *im,
+                                     const SDL_KeyboardEvent *event)
+{
+    if (event->repeat)
+    {
+        return;
+    }
+
+    SDL_Scancode scancode = event->keysym.scancode;
+    if (scancode >= 0 && scancode < SDL_NUM_SCANCODES)
+    {
+        sc_input_manager_process_fpsgame_binding(
+            im, &im->fpsgame_keys->keys[scancode],
+            event->type == SDL_KEYDOWN);
+    }
+}
+
 static void
 sc_input_manager_process_key(struct sc_input_manager *im,
-                             const SDL_KeyboardEvent *event,
-                             bool mouse_capture)
+                             const SDL_KeyboardEvent *event)
 {
     // 如果--no-control，则controller为NULL
     struct sc_controller *controller = im->controller;
@@ -508,346 +642,6 @@ sc_input_manager_process_key(struct sc_input_manager *im,
         }
     }
 
-    if (mouse_capture)
-    {
-        // 如果鼠标在手机里
-        SDL_EventType action = down ? SDL_FINGERDOWN : SDL_FINGERUP;
-        struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
-        switch (keycode)
-        {
-        case SDLK_w: // 前进
-            if (!repeat)
-            {
-                int rx = sfk->rouletteX;
-                if (rx < 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX - sfk->wheelLeftOffset,
-                        sfk->wheelCenterposY - (down ? sfk->wheelUpOffset : 0),
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else if (rx > 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX + sfk->wheelRightOffset,
-                        sfk->wheelCenterposY - (down ? sfk->wheelUpOffset : 0),
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else
-                {
-                    if (down)
-                    {
-                        sc_input_manager_send_touch_event(
-                            im,
-                            sfk->wheelCenterposX,
-                            sfk->wheelCenterposY,
-                            SDL_FINGERDOWN,
-                            (SDL_FingerID)1);
-                    }
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX,
-                        sfk->wheelCenterposY - (down ? sfk->wheelUpOffset : 0),
-                        down ? SDL_FINGERMOTION : SDL_FINGERUP,
-                        1);
-                }
-                sfk->rouletteY += down ? 1 : -1;
-            }
-            return;
-        case SDLK_s: // 后退
-            if (!repeat)
-            {
-                int rx = sfk->rouletteX;
-                if (rx < 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX - sfk->wheelLeftOffset,
-                        sfk->wheelCenterposY + (down ? sfk->wheeldownOffset : 0),
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else if (rx > 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX + sfk->wheelRightOffset,
-                        sfk->wheelCenterposY + (down ? sfk->wheeldownOffset : 0),
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else
-                {
-                    if (down)
-                    {
-                        sc_input_manager_send_touch_event(
-                            im,
-                            sfk->wheelCenterposX,
-                            sfk->wheelCenterposY,
-                            SDL_FINGERDOWN,
-                            1);
-                    }
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX,
-                        sfk->wheelCenterposY + (down ? sfk->wheeldownOffset : 0),
-                        down ? SDL_FINGERMOTION : SDL_FINGERUP,
-                        1);
-                }
-                sfk->rouletteY -= down ? 1 : -1;
-            }
-            return;
-        case SDLK_a: // 左
-            if (!repeat)
-            {
-                int ry = sfk->rouletteY;
-                if (ry < 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX - (down ? sfk->wheelLeftOffset : 0),
-                        sfk->wheelCenterposY + sfk->wheeldownOffset,
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else if (ry > 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX - (down ? sfk->wheelLeftOffset : 0),
-                        sfk->wheelCenterposY - sfk->wheelUpOffset,
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else
-                {
-                    if (down)
-                    {
-                        sc_input_manager_send_touch_event(
-                            im,
-                            sfk->wheelCenterposX,
-                            sfk->wheelCenterposY,
-                            SDL_FINGERDOWN,
-                            1);
-                    }
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX - (down ? sfk->wheelLeftOffset : 0),
-                        sfk->wheelCenterposY,
-                        down ? SDL_FINGERMOTION : SDL_FINGERUP,
-                        1);
-                }
-                sfk->rouletteX -= down ? 1 : -1;
-            }
-            return;
-        case SDLK_d: // 右
-            if (!repeat)
-            {
-                int ry = sfk->rouletteY;
-                if (ry < 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX + (down ? sfk->wheelRightOffset : 0),
-                        sfk->wheelCenterposY + sfk->wheeldownOffset,
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else if (ry > 0)
-                {
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX + (down ? sfk->wheelRightOffset : 0),
-                        sfk->wheelCenterposY - sfk->wheelUpOffset,
-                        SDL_FINGERMOTION,
-                        1);
-                }
-                else
-                {
-                    if (down)
-                    {
-                        sc_input_manager_send_touch_event(
-                            im,
-                            sfk->wheelCenterposX,
-                            sfk->wheelCenterposY,
-                            SDL_FINGERDOWN,
-                            1);
-                    }
-                    sc_input_manager_send_touch_event(
-                        im,
-                        sfk->wheelCenterposX + (down ? sfk->wheelRightOffset : 0),
-                        sfk->wheelCenterposY,
-                        down ? SDL_FINGERMOTION : SDL_FINGERUP,
-                        1);
-                }
-                sfk->rouletteX += down ? 1 : -1;
-            }
-            return;
-        case SDLK_q: // 左探头
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(
-                    im,
-                    sfk->leftProbeX,
-                    sfk->leftProbeY,
-                    action,
-                    3);
-            }
-            return;
-        case SDLK_e: // 右探头
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(
-                    im,
-                    sfk->rightProbeX,
-                    sfk->rightProbeY,
-                    action,
-                    3);
-            }
-            return;
-        case SDLK_EQUALS: // 自动跑
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(
-                    im,
-                    sfk->autoRunX,
-                    sfk->autoRunY,
-                    action,
-                    3);
-            }
-            return;
-        case SDLK_SPACE: // 跳
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(
-                    im,
-                    sfk->jumpX,
-                    sfk->jumpY,
-                    action,
-                    11);
-            }
-            return;
-        case SDLK_m: // 地图
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(
-                    im,
-                    sfk->mapX,
-                    sfk->mapY,
-                    action,
-                    10);
-            }
-            return;
-        case SDLK_TAB: // 背包
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->knapsackX, sfk->knapsackY, action, 9);
-            }
-            return;
-        case SDLK_z: // 趴
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->dropX, sfk->dropY, action, 8);
-            }
-            return;
-        case SDLK_c: // 蹲
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->squatX, sfk->squatY, action, 7);
-            }
-            return;
-        case SDLK_r: // 装弹
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->reloadX, sfk->reloadY, action, 6);
-            }
-            return;
-        case SDLK_f: // 拾取1
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->pickup1X, sfk->pickup1Y, action, 3);
-            }
-            return;
-        case SDLK_g: // 拾取2
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->pickup2X, sfk->pickup2Y, action, 3);
-            }
-            return;
-        case SDLK_h: // 拾取3
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->pickup3X, sfk->pickup3Y, action, 3);
-            }
-            return;
-        case SDLK_1: // 换枪1
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->switchGun1X, sfk->switchGun1Y, action, 4);
-            }
-            return;
-        case SDLK_2: // 换枪2
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->switchGun2X, sfk->switchGun2Y, action, 5);
-            }
-            return;
-        case SDLK_3: // 打药
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->medicineX, sfk->medicineY, action, 3);
-            }
-            return;
-        case SDLK_4: // 手雷
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->fragX, sfk->fragY, action, 3);
-            }
-            return;
-        case SDLK_5: // 下车
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->getOffCarX, sfk->getOffCarY, action, 3);
-            }
-            return;
-        case SDLK_6: // 救人
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->helpX, sfk->helpY, action, 3);
-            }
-            return;
-        case SDLK_7: // 上车
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->getOnCarX, sfk->getOnCarY, action, 3);
-            }
-            return;
-        case SDLK_x: // 开门
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->openDoorX, sfk->openDoorY, action, 3);
-            }
-            return;
-        case SDLK_t: // 舔包
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->lickBagX, sfk->lickBagY, action, 3);
-            }
-            return;
-        case SDLK_b: // 标点
-            if (!repeat)
-            {
-                sc_input_manager_send_touch_event(im, sfk->punctuationX, sfk->punctuationY, action, 3);
-            }
-            return;
-        }
-        return;
-    }
-    else
     {
 
         // The shortcut modifier is pressed
@@ -1008,6 +802,12 @@ sc_input_manager_process_key(struct sc_input_manager *im,
                 switch_fps_counter_state(&im->screen->fps_counter);
             }
             return;
+        case SDLK_z: // 切换感兴趣区域/整帧
+            if (!shift && !repeat && down)
+            {
+                sc_screen_switch_roi(im->screen);
+            }
+            return;
         case SDLK_n:
             if (controller && !repeat && down)
             {
@@ -1085,27 +885,160 @@ sc_input_manager_process_key(struct sc_input_manager *im,
     im->kp->ops->process_key(im->kp, &evt, ack_to_wait);
 }
 
+// 显示器刷新周期，无法获取时使用 60Hz
+static sc_tick
+sc_input_manager_get_vsync_interval(struct sc_input_manager *im)
+{
+    int refresh_rate = 60;
+    int index = SDL_GetWindowDisplayIndex(im->screen->window);
+    SDL_DisplayMode mode;
+    if (index >= 0 && !SDL_GetCurrentDisplayMode(index, &mode)
+            && mode.refresh_rate > 0)
+    {
+        refresh_rate = mode.refresh_rate;
+    }
+    return SC_TICK_FREQ / refresh_rate;
+}
+
+// 视角手指在视角中心点按下
 static void
-sc_input_manager_process_mouse_motion(struct sc_input_manager *im,
-                                      const SDL_MouseMotionEvent *event,
-                                      bool mouse_capture)
+sc_input_manager_aim_press(struct sc_input_manager *im)
 {
-    if (mouse_capture)
+    struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+    sfk->aimX = sfk->pointX;
+    sfk->aimY = sfk->pointY;
+    sc_input_manager_send_touch_event(im, sfk->aimX, sfk->aimY,
+                                      SDL_FINGERDOWN, sfk->aimPointer);
+}
+
+// 视角手指移动到 (x, y)
+// 视角点以浮点数累加，不足一个像素的移动保留到下一次事件，只有跨过像素边界
+// 时才发送
+static void
+sc_input_manager_aim_move(struct sc_input_manager *im, float x, float y)
+{
+    struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+    struct sc_size frame_size = im->geometry.frame_size;
+    enum sc_orientation orientation = im->geometry.orientation;
+    struct sc_point from = sc_fpsgame_keys_to_frame_point(frame_size,
+                                                          orientation,
+                                                          sfk->aimX,
+                                                          sfk->aimY);
+    struct sc_point to =
+        sc_fpsgame_keys_to_frame_point(frame_size, orientation, x, y);
+    bool moved = from.x != to.x || from.y != to.y;
+    sfk->aimX = x;
+    sfk->aimY = y;
+    if (moved)
     {
-        struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
-        float px = sfk->pointX + sfk->speedRatioX * (float)event->xrel;
-        float py = sfk->pointY + sfk->speedRatioY * (float)event->yrel;
-        bool flag = px < 0 || px > 1 || py < 0 || py > 1;
-        if (flag)
-        {
-            sc_input_manager_send_touch_event(im, sfk->pointX, sfk->pointY, SDL_FINGERUP, 2);
-            sfk->pointX = 0.55, sfk->pointY = 0.4;
-        } else {
-            sfk->pointX = px, sfk->pointY = py;
-        }
-        sc_input_manager_send_touch_event(im, sfk->pointX, sfk->pointY, flag ? SDL_FINGERDOWN : SDL_FINGERMOTION, 2);
+        sc_input_manager_send_touch_event(im, x, y, SDL_FINGERMOTION,
+                                          sfk->aimPointer);
+    }
+}
+
+// 视角点移动 (dx, dy)，移动量已经过灵敏度曲线
+static void
+sc_input_manager_process_aim(struct sc_input_manager *im, float dx, float dy)
+{
+    struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+    float px = sfk->aimX + dx;
+    float py = sfk->aimY + dy;
+
+    // 距离以屏幕高度为单位，水平和垂直方向的半径相同
+    struct sc_size size =
+        sc_fpsgame_keys_get_oriented_size(im->geometry.frame_size,
+                                          im->geometry.orientation);
+    float ox = (px - sfk->pointX) * size.width / size.height;
+    float oy = py - sfk->pointY;
+    float r = sfk->aim.recenter_radius;
+    bool outside = px < 0 || px > 1 || py < 0 || py > 1;
+    if (!outside && ox * ox + oy * oy <= r * r)
+    {
+        sc_input_manager_aim_move(im, px, py);
         return;
     }
+
+    // 回中：先用另一个手指在中心点按下，再抬起旧手指，游戏始终能看到至少
+    // 一个视角手指，不会出现抬起再按下造成的跳动。本次事件的移动量由新手指
+    // 继续完成。
+    SDL_FingerID old_pointer = sfk->aimPointer;
+    float old_x = sfk->aimX;
+    float old_y = sfk->aimY;
+    sfk->aimPointer = old_pointer == SC_FPSGAME_POINTER_AIM
+                    ? SC_FPSGAME_POINTER_AIM_ALT
+                    : SC_FPSGAME_POINTER_AIM;
+    sc_input_manager_aim_press(im);
+    sc_input_manager_send_touch_event(im, old_x, old_y, SDL_FINGERUP,
+                                      old_pointer);
+    sc_input_manager_aim_move(im, sfk->pointX + dx, sfk->pointY + dy);
+}
+
+static void
+sc_input_manager_flush_aim(struct sc_input_manager *im, sc_tick now)
+{
+    float dx = im->aim_coalesce.dx;
+    float dy = im->aim_coalesce.dy;
+    im->aim_coalesce.dx = 0;
+    im->aim_coalesce.dy = 0;
+    im->aim_coalesce.pending = false;
+    im->aim_coalesce.next_flush = now + im->aim_coalesce.interval;
+    im->timestamp = im->aim_coalesce.timestamp;
+    if (dx || dy)
+    {
+        sc_input_manager_process_aim(im, dx, dy);
+    }
+}
+
+// 合并视角移动：距离上次发送超过一个周期时立即发送，否则累加，由输入线程
+// 在 next_flush 时发送。每个事件先经过灵敏度曲线再累加，合并不改变总移动量。
+static void
+sc_input_manager_coalesce_aim(struct sc_input_manager *im,
+                              int32_t xrel, int32_t yrel)
+{
+    struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+    if (!im->aim_coalesce.pending)
+    {
+        // 合并的移动从最早的事件开始计算延迟
+        im->aim_coalesce.timestamp = im->timestamp;
+    }
+    sc_fpsgame_aim_accumulate(&sfk->aim, xrel, yrel,
+                              sfk->speedRatioX, sfk->speedRatioY,
+                              &im->aim_coalesce.dx, &im->aim_coalesce.dy);
+
+    sc_tick now = sc_tick_now();
+    if (now >= im->aim_coalesce.next_flush)
+    {
+        sc_input_manager_flush_aim(im, now);
+        return;
+    }
+
+    im->aim_coalesce.pending = true;
+}
+
+// 捕获鼠标时的鼠标移动，在输入线程中执行
+static void
+sc_input_manager_process_fpsgame_motion(struct sc_input_manager *im,
+                                        const SDL_MouseMotionEvent *event)
+{
+    if (im->aim_coalesce.interval)
+    {
+        sc_input_manager_coalesce_aim(im, event->xrel, event->yrel);
+    }
+    else
+    {
+        struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+        float dx;
+        float dy;
+        sc_fpsgame_aim_apply(&sfk->aim, event->xrel, event->yrel,
+                             sfk->speedRatioX, sfk->speedRatioY, &dx, &dy);
+        sc_input_manager_process_aim(im, dx, dy);
+    }
+}
+
+static void
+sc_input_manager_process_mouse_motion(struct sc_input_manager *im,
+                                      const SDL_MouseMotionEvent *event)
+{
     struct sc_mouse_motion_event evt = {
         .position = {
             .screen_size = im->screen->frame_size,
@@ -1163,30 +1096,27 @@ sc_input_manager_process_touch(struct sc_input_manager *im,
     im->mp->ops->process_touch(im->mp, &evt);
 }
 
+// 捕获鼠标时的鼠标按键，在输入线程中执行
+static void
+sc_input_manager_process_fpsgame_button(struct sc_input_manager *im,
+                                        const SDL_MouseButtonEvent *event)
+{
+    if (event->button < SC_FPSGAME_MOUSE_BUTTONS)
+    {
+        sc_input_manager_process_fpsgame_binding(
+            im, &im->fpsgame_keys->buttons[event->button],
+            event->type == SDL_MOUSEBUTTONDOWN);
+    }
+}
+
 static void
 sc_input_manager_process_mouse_button(struct sc_input_manager *im,
-                                      const SDL_MouseButtonEvent *event,
-                                      bool mouse_capture)
+                                      const SDL_MouseButtonEvent *event)
 {
     struct sc_controller *controller = im->controller;
 
     bool down = event->type == SDL_MOUSEBUTTONDOWN;
 
-    if (mouse_capture) {
-        struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
-        SDL_EventType action = down ? SDL_FINGERDOWN : SDL_FINGERUP;
-        if (event->button == SDL_BUTTON_LEFT) {
-            sc_input_manager_send_touch_event(im, sfk->fireX, sfk->fireY, action, 12);
-        } else if (event->button == SDL_BUTTON_RIGHT)
-        {
-            sc_input_manager_send_touch_event(im, sfk->openMirrorX, sfk->openMirrorY, action, 13);
-        } else if (event->button == SDL_BUTTON_MIDDLE)
-        {
-            sc_input_manager_send_touch_event(im, sfk->punctuationX, sfk->punctuationY, action, 14);
-        }
-        return;
-    }
-
     if (!im->forward_all_clicks)
     {
         if (controller)
@@ -1369,11 +1299,245 @@ sc_input_manager_process_file(struct sc_input_manager *im,
     }
 }
 
+// 在输入线程中执行
+static void
+sc_input_manager_process_input_event(struct sc_input_manager *im,
+                                     const struct sc_input_event *event)
+{
+    struct sc_fpsgame_keys *sfk = im->fpsgame_keys;
+    // 合并的视角移动在没有事件时发送，使用最近的几何信息
+    im->geometry = event->geometry;
+    im->timestamp = event->timestamp;
+    switch (event->type)
+    {
+    case SC_INPUT_EVENT_AIM_START:
+        im->aim_coalesce.interval = event->interval;
+        im->aim_coalesce.dx = 0;
+        im->aim_coalesce.dy = 0;
+        im->aim_coalesce.pending = false;
+        sc_input_manager_aim_press(im);
+        break;
+    case SC_INPUT_EVENT_AIM_STOP:
+        sc_input_manager_send_touch_event(im, sfk->aimX, sfk->aimY,
+                                          SDL_FINGERUP, sfk->aimPointer);
+        // 丢弃尚未发送的移动
+        im->aim_coalesce.pending = false;
+        break;
+    default:
+        assert(event->type == SC_INPUT_EVENT_SDL);
+        switch (event->sdl.type)
+        {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            sc_input_manager_process_fpsgame_key(im, &event->sdl.key);
+            break;
+        case SDL_MOUSEMOTION:
+            sc_input_manager_process_fpsgame_motion(im, &event->sdl.motion);
+            break;
+        default:
+            assert(event->sdl.type == SDL_MOUSEBUTTONDOWN
+                || event->sdl.type == SDL_MOUSEBUTTONUP);
+            sc_input_manager_process_fpsgame_button(im, &event->sdl.button);
+            break;
+        }
+        break;
+    }
+}
+
+static int
+run_input_manager(void *data)
+{
+    struct sc_input_manager *im = data;
+
+    for (;;)
+    {
+        sc_mutex_lock(&im->mutex);
+        bool timeout = false;
+        while (!im->stopped && sc_vecdeque_is_empty(&im->queue) && !timeout)
+        {
+            if (im->aim_coalesce.pending)
+            {
+                // 等待到下一次发送合并的视角移动
+                timeout = !sc_cond_timedwait(&im->cond, &im->mutex,
+                                             im->aim_coalesce.next_flush);
+            }
+            else
+            {
+                sc_cond_wait(&im->cond, &im->mutex);
+            }
+        }
+
+        if (im->stopped)
+        {
+            sc_mutex_unlock(&im->mutex);
+            break;
+        }
+
+        struct sc_input_event event;
+        bool has_event = !sc_vecdeque_is_empty(&im->queue);
+        if (has_event)
+        {
+            event = sc_vecdeque_pop(&im->queue);
+        }
+        sc_mutex_unlock(&im->mutex);
+
+        if (has_event)
+        {
+            sc_input_manager_process_input_event(im, &event);
+        }
+
+        if (im->aim_coalesce.pending)
+        {
+            sc_tick now = sc_tick_now();
+            if (now >= im->aim_coalesce.next_flush)
+            {
+                sc_input_manager_flush_aim(im, now);
+            }
+        }
+    }
+
+    LOGD("Input manager thread ended");
+    return 0;
+}
+
+// 在UI线程中调用，screen 只能在UI线程中访问
+static struct sc_input_geometry
+sc_input_manager_get_geometry(struct sc_input_manager *im)
+{
+    struct sc_input_geometry geometry = {
+        .frame_size = im->screen->frame_size,
+        .orientation = im->screen->orientation,
+    };
+    return geometry;
+}
+
+static void
+sc_input_manager_push(struct sc_input_manager *im,
+                      struct sc_input_event *event)
+{
+    event->geometry = sc_input_manager_get_geometry(im);
+
+    sc_mutex_lock(&im->mutex);
+    bool was_empty = sc_vecdeque_is_empty(&im->queue);
+    // 输入事件不能丢弃（按下和抬起必须成对），队列满时扩容
+    bool ok = sc_vecdeque_push(&im->queue, *event);
+    if (!ok)
+    {
+        LOG_OOM();
+    }
+    else if (was_empty)
+    {
+        sc_cond_signal(&im->cond);
+    }
+    sc_mutex_unlock(&im->mutex);
+}
+
+void
+sc_input_manager_aim_start(struct sc_input_manager *im)
+{
+    struct sc_input_event event = {
+        .type = SC_INPUT_EVENT_AIM_START,
+        .timestamp = sc_tick_now(),
+    };
+
+    // 每次开始捕获时重新计算，窗口可能已经移动到另一个显示器
+    // SDL 视频函数只能在UI线程中调用
+    const struct sc_fpsgame_aim *aim = &im->fpsgame_keys->aim;
+    switch (aim->coalesce)
+    {
+    case SC_FPSGAME_AIM_COALESCE_VSYNC:
+        event.interval = sc_input_manager_get_vsync_interval(im);
+        break;
+    case SC_FPSGAME_AIM_COALESCE_INTERVAL:
+        event.interval = aim->coalesce_interval;
+        break;
+    default:
+        event.interval = 0;
+        break;
+    }
+
+    sc_input_manager_push(im, &event);
+}
+
+void
+sc_input_manager_aim_stop(struct sc_input_manager *im)
+{
+    struct sc_input_event event = {
+        .type = SC_INPUT_EVENT_AIM_STOP,
+        .timestamp = sc_tick_now(),
+    };
+    sc_input_manager_push(im, &event);
+}
+
+bool
+sc_input_manager_start(struct sc_input_manager *im)
+{
+    LOGD("Starting input manager thread");
+
+    bool ok = sc_thread_create(&im->thread, run_input_manager,
+                               "scrcpy-input", im);
+    if (!ok)
+    {
+        LOGE("Could not start input manager thread");
+        return false;
+    }
+
+    return true;
+}
+
+void
+sc_input_manager_stop(struct sc_input_manager *im)
+{
+    sc_mutex_lock(&im->mutex);
+    im->stopped = true;
+    sc_cond_signal(&im->cond);
+    sc_mutex_unlock(&im->mutex);
+}
+
+void
+sc_input_manager_join(struct sc_input_manager *im)
+{
+    sc_thread_join(&im->thread, NULL);
+}
+
+void
+sc_input_manager_destroy(struct sc_input_manager *im)
+{
+    sc_cond_destroy(&im->cond);
+    sc_mutex_destroy(&im->mutex);
+    sc_vecdeque_destroy(&im->queue);
+}
+
 void sc_input_manager_handle_event(struct sc_input_manager *im,
                                    const SDL_Event *event,
                                    bool mouse_capture)
 {
     bool control = im->controller;
+
+    if (mouse_capture)
+    {
+        // 捕获鼠标时，键盘和鼠标事件交给输入线程处理，不受渲染的影响
+        switch (event->type)
+        {
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+        case SDL_MOUSEMOTION:
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+        {
+            struct sc_input_event evt = {
+                .type = SC_INPUT_EVENT_SDL,
+                .timestamp = sc_tick_now(),
+                .sdl = *event,
+            };
+            sc_input_manager_push(im, &evt);
+            return;
+        }
+        default:
+            break;
+        }
+    }
+
     switch (event->type)
     {
     case SDL_TEXTINPUT: // 文本输入
@@ -1385,10 +1549,10 @@ void sc_input_manager_handle_event(struct sc_input_manager *im,
         break;
     case SDL_KEYDOWN: // 键盘按键
     case SDL_KEYUP:
-        sc_input_manager_process_key(im, &event->key, mouse_capture);
+        sc_input_manager_process_key(im, &event->key);
         break;
     case SDL_MOUSEMOTION: // 鼠标移动
-        sc_input_manager_process_mouse_motion(im, &event->motion, mouse_capture);
+        sc_input_manager_process_mouse_motion(im, &event->motion);
         break;
     case SDL_MOUSEWHEEL: // 鼠标滚轮
         if (!control)
@@ -1401,7 +1565,7 @@ void sc_input_manager_handle_event(struct sc_input_manager *im,
     case SDL_MOUSEBUTTONUP:
         // some mouse events do not interact with the device, so process
         // the event even if control is disabled
-        sc_input_manager_process_mouse_button(im, &event->button, mouse_capture);
+        sc_input_manager_process_mouse_button(im, &event->button);
         break;
     case SDL_FINGERMOTION: // 手指
     case SDL_FINGERDOWN:
@@ -1419,6 +1583,7 @@ void sc_input_manager_handle_event(struct sc_input_manager *im,
             break;
         }
         sc_input_manager_process_file(im, &event->drop);
+        break;
     }
     }
 }
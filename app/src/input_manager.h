@@ -8,12 +8,46 @@
 #include <SDL2/SDL.h>
 
 #include "controller.h"
+#include "coords.h"
 #include "file_pusher.h"
 #include "fps_counter.h"
 #include "options.h"
 #include "trait/key_processor.h"
 #include "trait/mouse_processor.h"
 #include "keymap/fpsgame_keys.h"
+#include "util/thread.h"
+#include "util/tick.h"
+#include "util/vecdeque.h"
+
+enum sc_input_event_type
+{
+    SC_INPUT_EVENT_SDL, // 捕获鼠标时的键盘或鼠标事件
+    SC_INPUT_EVENT_AIM_START, // 开始捕获鼠标
+    SC_INPUT_EVENT_AIM_STOP, // 结束捕获鼠标
+};
+
+// 屏幕几何信息的快照：由UI线程随每个事件发送，输入线程不直接读取 screen
+struct sc_input_geometry
+{
+    // 整个设备画面的大小，不受 --render-roi 影响
+    struct sc_size frame_size;
+    enum sc_orientation orientation;
+};
+
+// 交给输入线程处理的事件
+struct sc_input_event
+{
+    enum sc_input_event_type type;
+    sc_tick timestamp; // 在UI线程中收到事件的时间
+    struct sc_input_geometry geometry; // 收到事件时的屏幕几何信息
+    union
+    {
+        SDL_Event sdl;
+        sc_tick interval; // SC_INPUT_EVENT_AIM_START：视角移动合并周期
+    };
+};
+
+struct sc_input_event_queue SC_VECDEQUE(struct sc_input_event);
 
 struct sc_input_manager
 {
@@ -38,6 +72,32 @@ struct sc_input_manager
 
     bool vfinger_down;
 
+    // 捕获鼠标时，FPS 按键映射在独立的输入线程中执行，渲染耗时不会增加输入
+    // 延迟
+    sc_thread thread;
+    sc_mutex mutex;
+    sc_cond cond;
+    struct sc_input_event_queue queue;
+    bool stopped;
+
+    // 捕获鼠标时合并的视角移动，只在输入线程中访问
+    struct
+    {
+        // 已经过灵敏度曲线的视角点移动之和
+        float dx;
+        float dy;
+        sc_tick interval; // 0 表示不合并
+        sc_tick next_flush;
+        bool pending; // 有尚未发送的移动，在 next_flush 时发送
+        sc_tick timestamp; // 合并的第一个事件的时间
+    } aim_coalesce;
+
+    // 最近一个事件携带的屏幕几何信息，只在输入线程中访问
+    struct sc_input_geometry geometry;
+    // 当前处理的事件在UI线程中收到的时间，用于测量输入延迟，只在输入线程中
+    // 访问
+    sc_tick timestamp;
+
     // 跟踪相同的连续快捷键按下事件的数量。
     // 不要与event->repeat混淆，后者统计系统生成的重复按键次数。
     unsigned key_repeat;
@@ -62,9 +122,17 @@ struct sc_input_manager_params
     const struct sc_shortcut_mods *shortcut_mods;
 };
 
-void sc_input_manager_init(struct sc_input_manager *im,
+bool sc_input_manager_init(struct sc_input_manager *im,
                            const struct sc_input_manager_params *params);
 
+void sc_input_manager_destroy(struct sc_input_manager *im);
+
+bool sc_input_manager_start(struct sc_input_manager *im);
+
+void sc_input_manager_stop(struct sc_input_manager *im);
+
+void sc_input_manager_join(struct sc_input_manager *im);
+
 void sc_input_manager_handle_event(struct sc_input_manager *im,
                                    const SDL_Event *event,
                                    bool mouse_capture);
@@ -74,4 +142,8 @@ void sc_input_manager_send_touch_event(
     Uint32 type,
     SDL_FingerID fingerId);
 
+// 捕获鼠标时按下视角手指（位于视角中心点），取消捕获时抬起
+void sc_input_manager_aim_start(struct sc_input_manager *im);
+void sc_input_manager_aim_stop(struct sc_input_manager *im);
+
 #endif
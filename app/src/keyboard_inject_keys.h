@@ -0,0 +1,135 @@
+#ifndef SC_KEYBOARD_INJECT_KEYS_H
+#define SC_KEYBOARD_INJECT_KEYS_H
+
+#include "common.h"
+
+#include "android/keycodes.h"
+#include "input_events.h"
+#include "util/intmap.h"
+
+// Conversion tables from scrcpy (SDL) keycodes to Android keycodes, used by
+// keyboard_inject.c (only included by it and by the unit tests).
+//
+// All the tables are sorted by SDL keycode value, so that lookups can use a
+// binary search (the order is checked by test_intmap).
+
+// Navigation keys and ENTER.
+// Used in all modes.
+static const struct sc_intmap_entry sc_special_keys[] = {
+    {SC_KEYCODE_BACKSPACE, AKEYCODE_DEL},
+    {SC_KEYCODE_TAB,       AKEYCODE_TAB},
+    {SC_KEYCODE_RETURN,    AKEYCODE_ENTER},
+    {SC_KEYCODE_ESCAPE,    AKEYCODE_ESCAPE},
+    {SC_KEYCODE_DELETE,    AKEYCODE_FORWARD_DEL},
+    {SC_KEYCODE_HOME,      AKEYCODE_MOVE_HOME},
+    {SC_KEYCODE_PAGEUP,    AKEYCODE_PAGE_UP},
+    {SC_KEYCODE_END,       AKEYCODE_MOVE_END},
+    {SC_KEYCODE_PAGEDOWN,  AKEYCODE_PAGE_DOWN},
+    {SC_KEYCODE_RIGHT,     AKEYCODE_DPAD_RIGHT},
+    {SC_KEYCODE_LEFT,      AKEYCODE_DPAD_LEFT},
+    {SC_KEYCODE_DOWN,      AKEYCODE_DPAD_DOWN},
+    {SC_KEYCODE_UP,        AKEYCODE_DPAD_UP},
+    {SC_KEYCODE_KP_ENTER,  AKEYCODE_NUMPAD_ENTER},
+    {SC_KEYCODE_LCTRL,     AKEYCODE_CTRL_LEFT},
+    {SC_KEYCODE_LSHIFT,    AKEYCODE_SHIFT_LEFT},
+    {SC_KEYCODE_RCTRL,     AKEYCODE_CTRL_RIGHT},
+    {SC_KEYCODE_RSHIFT,    AKEYCODE_SHIFT_RIGHT},
+};
+
+// Numpad navigation keys.
+// Used in all modes, when NumLock and Shift are disabled.
+static const struct sc_intmap_entry sc_kp_nav_keys[] = {
+    {SC_KEYCODE_KP_1,      AKEYCODE_MOVE_END},
+    {SC_KEYCODE_KP_2,      AKEYCODE_DPAD_DOWN},
+    {SC_KEYCODE_KP_3,      AKEYCODE_PAGE_DOWN},
+    {SC_KEYCODE_KP_4,      AKEYCODE_DPAD_LEFT},
+    {SC_KEYCODE_KP_6,      AKEYCODE_DPAD_RIGHT},
+    {SC_KEYCODE_KP_7,      AKEYCODE_MOVE_HOME},
+    {SC_KEYCODE_KP_8,      AKEYCODE_DPAD_UP},
+    {SC_KEYCODE_KP_9,      AKEYCODE_PAGE_UP},
+    {SC_KEYCODE_KP_0,      AKEYCODE_INSERT},
+    {SC_KEYCODE_KP_PERIOD, AKEYCODE_FORWARD_DEL},
+};
+
+// Letters and space.
+// Used in non-text mode.
+static const struct sc_intmap_entry sc_alphaspace_keys[] = {
+    {SC_KEYCODE_SPACE,     AKEYCODE_SPACE},
+    {SC_KEYCODE_a,         AKEYCODE_A},
+    {SC_KEYCODE_b,         AKEYCODE_B},
+    {SC_KEYCODE_c,         AKEYCODE_C},
+    {SC_KEYCODE_d,         AKEYCODE_D},
+    {SC_KEYCODE_e,         AKEYCODE_E},
+    {SC_KEYCODE_f,         AKEYCODE_F},
+    {SC_KEYCODE_g,         AKEYCODE_G},
+    {SC_KEYCODE_h,         AKEYCODE_H},
+    {SC_KEYCODE_i,         AKEYCODE_I},
+    {SC_KEYCODE_j,         AKEYCODE_J},
+    {SC_KEYCODE_k,         AKEYCODE_K},
+    {SC_KEYCODE_l,         AKEYCODE_L},
+    {SC_KEYCODE_m,         AKEYCODE_M},
+    {SC_KEYCODE_n,         AKEYCODE_N},
+    {SC_KEYCODE_o,         AKEYCODE_O},
+    {SC_KEYCODE_p,         AKEYCODE_P},
+    {SC_KEYCODE_q,         AKEYCODE_Q},
+    {SC_KEYCODE_r,         AKEYCODE_R},
+    {SC_KEYCODE_s,         AKEYCODE_S},
+    {SC_KEYCODE_t,         AKEYCODE_T},
+    {SC_KEYCODE_u,         AKEYCODE_U},
+    {SC_KEYCODE_v,         AKEYCODE_V},
+    {SC_KEYCODE_w,         AKEYCODE_W},
+    {SC_KEYCODE_x,         AKEYCODE_X},
+    {SC_KEYCODE_y,         AKEYCODE_Y},
+    {SC_KEYCODE_z,         AKEYCODE_Z},
+};
+
+// Numbers and punctuation keys.
+// Used in raw mode only.
+static const struct sc_intmap_entry sc_numbers_punct_keys[] = {
+    {SC_KEYCODE_HASH,          AKEYCODE_POUND},
+    {SC_KEYCODE_PERCENT,       AKEYCODE_PERIOD},
+    {SC_KEYCODE_QUOTE,         AKEYCODE_APOSTROPHE},
+    {SC_KEYCODE_ASTERISK,      AKEYCODE_STAR},
+    {SC_KEYCODE_PLUS,          AKEYCODE_PLUS},
+    {SC_KEYCODE_COMMA,         AKEYCODE_COMMA},
+    {SC_KEYCODE_MINUS,         AKEYCODE_MINUS},
+    {SC_KEYCODE_PERIOD,        AKEYCODE_PERIOD},
+    {SC_KEYCODE_SLASH,         AKEYCODE_SLASH},
+    {SC_KEYCODE_0,             AKEYCODE_0},
+    {SC_KEYCODE_1,             AKEYCODE_1},
+    {SC_KEYCODE_2,             AKEYCODE_2},
+    {SC_KEYCODE_3,             AKEYCODE_3},
+    {SC_KEYCODE_4,             AKEYCODE_4},
+    {SC_KEYCODE_5,             AKEYCODE_5},
+    {SC_KEYCODE_6,             AKEYCODE_6},
+    {SC_KEYCODE_7,             AKEYCODE_7},
+    {SC_KEYCODE_8,             AKEYCODE_8},
+    {SC_KEYCODE_9,             AKEYCODE_9},
+    {SC_KEYCODE_SEMICOLON,     AKEYCODE_SEMICOLON},
+    {SC_KEYCODE_EQUALS,        AKEYCODE_EQUALS},
+    {SC_KEYCODE_AT,            AKEYCODE_AT},
+    {SC_KEYCODE_LEFTBRACKET,   AKEYCODE_LEFT_BRACKET},
+    {SC_KEYCODE_BACKSLASH,     AKEYCODE_BACKSLASH},
+    {SC_KEYCODE_RIGHTBRACKET,  AKEYCODE_RIGHT_BRACKET},
+    {SC_KEYCODE_BACKQUOTE,     AKEYCODE_GRAVE},
+    {SC_KEYCODE_KP_DIVIDE,     AKEYCODE_NUMPAD_DIVIDE},
+    {SC_KEYCODE_KP_MULTIPLY,   AKEYCODE_NUMPAD_MULTIPLY},
+    {SC_KEYCODE_KP_MINUS,      AKEYCODE_NUMPAD_SUBTRACT},
+    {SC_KEYCODE_KP_PLUS,       AKEYCODE_NUMPAD_ADD},
+    {SC_KEYCODE_KP_1,          AKEYCODE_NUMPAD_1},
+    {SC_KEYCODE_KP_2,          AKEYCODE_NUMPAD_2},
+    {SC_KEYCODE_KP_3,          AKEYCODE_NUMPAD_3},
+    {SC_KEYCODE_KP_4,          AKEYCODE_NUMPAD_4},
+    {SC_KEYCODE_KP_5,          AKEYCODE_NUMPAD_5},
+    {SC_KEYCODE_KP_6,          AKEYCODE_NUMPAD_6},
+    {SC_KEYCODE_KP_7,          AKEYCODE_NUMPAD_7},
+    {SC_KEYCODE_KP_8,          AKEYCODE_NUMPAD_8},
+    {SC_KEYCODE_KP_9,          AKEYCODE_NUMPAD_9},
+    {SC_KEYCODE_KP_0,          AKEYCODE_NUMPAD_0},
+    {SC_KEYCODE_KP_PERIOD,     AKEYCODE_NUMPAD_DOT},
+    {SC_KEYCODE_KP_EQUALS,     AKEYCODE_NUMPAD_EQUALS},
+    {SC_KEYCODE_KP_LEFTPAREN,  AKEYCODE_NUMPAD_LEFT_PAREN},
+    {SC_KEYCODE_KP_RIGHTPAREN, AKEYCODE_NUMPAD_RIGHT_PAREN},
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "fpsgame_aim.h"
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/log.h"
+
+void
+sc_fpsgame_aim_init(struct sc_fpsgame_aim *aim) {
+    memset(aim, 0, sizeof(*aim));
+
+    aim->curve = SC_FPSGAME_AIM_CURVE_LINEAR;
+    aim->exponent = 1.2f;
+    aim->max_gain = 4.f;
+    aim->ads_sensitivity = 1.f;
+    aim->ads_pointer_id = 13; // 开镜（鼠标右键）
+    aim->recenter_radius = 0.35f;
+
+    sc_fpsgame_aim_update(aim);
+}
+
+static float
+table_gain(const struct sc_fpsgame_aim *aim, float speed) {
+    const struct sc_fpsgame_aim_point *t = aim->table;
+    unsigned len = aim->table_len;
+    if (!len) {
+        return 1.f;
+    }
+
+    if (speed <= t[0].speed) {
+        return t[0].gain;
+    }
+
+    for (unsigned i = 1; i < len; ++i) {
+        if (speed <= t[i].speed) {
+            float r = (speed - t[i - 1].speed) / (t[i].speed - t[i - 1].speed);
+            return t[i - 1].gain + r * (t[i].gain - t[i - 1].gain);
+        }
+    }
+
+    return t[len - 1].gain;
+}
+
+void
+sc_fpsgame_aim_update(struct sc_fpsgame_aim *aim) {
+    for (unsigned speed = 0; speed < SC_FPSGAME_AIM_LUT_SIZE; ++speed) {
+        float gain;
+        switch (aim->curve) {
+            case SC_FPSGAME_AIM_CURVE_POWER:
+                // 速度为 0 时不会移动，增益无关紧要
+                gain = speed ? powf(speed, aim->exponent - 1.f) : 1.f;
+                if (gain > aim->max_gain) {
+                    gain = aim->max_gain;
+                }
+                break;
+            case SC_FPSGAME_AIM_CURVE_TABLE:
+                gain = table_gain(aim, speed);
+                break;
+            default:
+                assert(aim->curve == SC_FPSGAME_AIM_CURVE_LINEAR);
+                gain = 1.f;
+                break;
+        }
+        aim->lut[speed] = gain;
+    }
+}
+
+static bool
+parse_curve(const char *s, enum sc_fpsgame_aim_curve *curve) {
+    if (!strcmp(s, "linear")) {
+        *curve = SC_FPSGAME_AIM_CURVE_LINEAR;
+    } else if (!strcmp(s, "power")) {
+        *curve = SC_FPSGAME_AIM_CURVE_POWER;
+    } else if (!strcmp(s, "table")) {
+        *curve = SC_FPSGAME_AIM_CURVE_TABLE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool
+parse_coalesce(struct sc_fpsgame_aim *aim, const char *s) {
+    if (!strcmp(s, "off")) {
+        aim->coalesce = SC_FPSGAME_AIM_COALESCE_OFF;
+        return true;
+    }
+    if (!strcmp(s, "vsync")) {
+        aim->coalesce = SC_FPSGAME_AIM_COALESCE_VSYNC;
+        return true;
+    }
+
+    unsigned value;
+    char unit[3];
+    if (sscanf(s, "%u%2s", &value, unit) != 2 || !value) {
+        return false;
+    }
+
+    sc_tick interval;
+    if (!strcmp(unit, "ms")) {
+        interval = SC_TICK_FROM_MS(value);
+    } else if (!strcmp(unit, "hz")) {
+        interval = SC_TICK_FREQ / value;
+    } else {
+        return false;
+    }
+
+    aim->coalesce = SC_FPSGAME_AIM_COALESCE_INTERVAL;
+    aim->coalesce_interval = interval;
+    return true;
+}
+
+static bool
+parse_table(struct sc_fpsgame_aim *aim, const char *s) {
+    struct sc_fpsgame_aim_point table[SC_FPSGAME_AIM_TABLE_MAX];
+    unsigned len = 0;
+
+    for (;;) {
+        float speed;
+        float gain;
+        int n = 0;
+        int r = sscanf(s, "%f %f%n", &speed, &gain, &n);
+        if (r == EOF) {
+            break;
+        }
+        if (r != 2 || len == SC_FPSGAME_AIM_TABLE_MAX || speed < 0
+                || (len && speed <= table[len - 1].speed)) {
+            return false;
+        }
+        table[len].speed = speed;
+        table[len].gain = gain;
+        ++len;
+        s += n;
+    }
+
+    if (!len) {
+        return false;
+    }
+
+    memcpy(aim->table, table, len * sizeof(*table));
+    aim->table_len = len;
+    return true;
+}
+
+bool
+sc_fpsgame_aim_parse_setting(struct sc_fpsgame_aim *aim, const char *key,
+                             const char *value) {
+    bool ok;
+    if (!strcmp(key, "aimCurve")) {
+        ok = parse_curve(value, &aim->curve);
+    } else if (!strcmp(key, "aimCurveTable")) {
+        ok = parse_table(aim, value);
+    } else if (!strcmp(key, "aimExponent")) {
+        ok = sscanf(value, "%f", &aim->exponent) == 1;
+    } else if (!strcmp(key, "aimMaxGain")) {
+        ok = sscanf(value, "%f", &aim->max_gain) == 1;
+    } else if (!strcmp(key, "aimCoalesce")) {
+        ok = parse_coalesce(aim, value);
+    } else if (!strcmp(key, "aimRecenterRadius")) {
+        ok = sscanf(value, "%f", &aim->recenter_radius) == 1;
+    } else if (!strcmp(key, "adsSensitivity")) {
+        ok = sscanf(value, "%f", &aim->ads_sensitivity) == 1;
+    } else if (!strcmp(key, "adsPointer")) {
+        unsigned pointer_id;
+        ok = sscanf(value, "%u", &pointer_id) == 1 && pointer_id <= UINT8_MAX;
+        if (ok) {
+            aim->ads_pointer_id = pointer_id;
+        }
+    } else {
+        LOGW("Unknown setting: \"%s\"", key);
+        return false;
+    }
+
+    if (!ok) {
+        LOGW("Invalid value for \"%s\": \"%s\"", key, value);
+        return false;
+    }
+
+    sc_fpsgame_aim_update(aim);
+    return true;
+}
+
+void
+sc_fpsgame_aim_apply(const struct sc_fpsgame_aim *aim, int32_t xrel,
+                     int32_t yrel, float ratio_x, float ratio_y,
+                     float *dx, float *dy) {
+    float fx = xrel;
+    float fy = yrel;
+    float speed = sqrtf(fx * fx + fy * fy);
+
+    unsigned index = speed + 0.5f;
+    if (index >= SC_FPSGAME_AIM_LUT_SIZE) {
+        index = SC_FPSGAME_AIM_LUT_SIZE - 1;
+    }
+
+    float gain = aim->lut[index];
+    if (aim->ads) {
+        gain *= aim->ads_sensitivity;
+    }
+
+    *dx = fx * gain * ratio_x;
+    *dy = fy * gain * ratio_y;
+}
+
+void
+sc_fpsgame_aim_accumulate(const struct sc_fpsgame_aim *aim, int32_t xrel,
+                          int32_t yrel, float ratio_x, float ratio_y,
+                          float *dx, float *dy) {
+    float x;
+    float y;
+    sc_fpsgame_aim_apply(aim, xrel, yrel, ratio_x, ratio_y, &x, &y);
+    *dx += x;
+    *dy += y;
+}
@@ -0,0 +1,101 @@
+#ifndef SC_FPSGAME_AIM_H
+#define SC_FPSGAME_AIM_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "util/tick.h"
+
+// 增益表的长度：按每个鼠标事件的移动量（单位：鼠标计数）索引，
+// 更快的移动使用最后一项
+#define SC_FPSGAME_AIM_LUT_SIZE 128
+
+// aimCurveTable 中最多的控制点数量
+#define SC_FPSGAME_AIM_TABLE_MAX 16
+
+enum sc_fpsgame_aim_curve {
+    SC_FPSGAME_AIM_CURVE_LINEAR, // 增益恒为 1
+    SC_FPSGAME_AIM_CURVE_POWER, // 增益 = 速度^(aimExponent - 1)
+    SC_FPSGAME_AIM_CURVE_TABLE, // 在 aimCurveTable 的控制点之间线性插值
+};
+
+enum sc_fpsgame_aim_coalesce {
+    SC_FPSGAME_AIM_COALESCE_OFF, // 每个鼠标事件立即发送
+    SC_FPSGAME_AIM_COALESCE_VSYNC, // 每个显示器刷新周期最多发送一次
+    SC_FPSGAME_AIM_COALESCE_INTERVAL, // 每 coalesce_interval 最多发送一次
+};
+
+struct sc_fpsgame_aim_point {
+    float speed;
+    float gain;
+};
+
+struct sc_fpsgame_aim {
+    enum sc_fpsgame_aim_curve curve;
+    float exponent; // SC_FPSGAME_AIM_CURVE_POWER 的指数
+    float max_gain; // SC_FPSGAME_AIM_CURVE_POWER 的增益上限
+    struct sc_fpsgame_aim_point table[SC_FPSGAME_AIM_TABLE_MAX];
+    unsigned table_len;
+
+    // 开镜时的灵敏度倍率
+    float ads_sensitivity;
+    // 开镜按键所使用的手指，按下期间使用 ads_sensitivity
+    uint8_t ads_pointer_id;
+    bool ads;
+
+    // 视角手指离开中心点超过该半径时回中（以屏幕高度为单位）
+    float recenter_radius;
+
+    // 合并鼠标移动事件，减少发送到设备的触摸事件数量
+    enum sc_fpsgame_aim_coalesce coalesce;
+    sc_tick coalesce_interval; // 仅用于 SC_FPSGAME_AIM_COALESCE_INTERVAL
+
+    // 预先计算的增益表，每个事件只需一次查表
+    float lut[SC_FPSGAME_AIM_LUT_SIZE];
+};
+
+// 初始化为线性曲线，开镜灵敏度为 1
+void
+sc_fpsgame_aim_init(struct sc_fpsgame_aim *aim);
+
+// 修改曲线参数后重新计算增益表
+void
+sc_fpsgame_aim_update(struct sc_fpsgame_aim *aim);
+
+/**
+ * 解析一个以 "aim" 或 "ads" 开头的设置：
+ *  - "aimCurve:<linear|power|table>"
+ *  - "aimExponent:<指数>"、"aimMaxGain:<上限>"
+ *  - "aimCurveTable:<速度> <增益> [<速度> <增益> ...]"，速度必须递增
+ *  - "adsSensitivity:<倍率>"、"adsPointer:<手指id>"
+ *  - "aimRecenterRadius:<半径>"
+ *  - "aimCoalesce:<off|vsync|<N>ms|<N>hz>"
+ */
+bool
+sc_fpsgame_aim_parse_setting(struct sc_fpsgame_aim *aim, const char *key,
+                             const char *value);
+
+/**
+ * 将鼠标相对移动转换为视角点的移动（单位与 ratio_x/ratio_y 相同）
+ *
+ * 结果为浮点数，由调用者累加，因此慢速的微小移动不会被舍入丢掉。
+ */
+void
+sc_fpsgame_aim_apply(const struct sc_fpsgame_aim *aim, int32_t xrel,
+                     int32_t yrel, float ratio_x, float ratio_y,
+                     float *dx, float *dy);
+
+/**
+ * 将鼠标相对移动转换为视角点的移动，并累加到 *dx、*dy
+ *
+ * 用于合并鼠标事件：曲线按每个事件自己的速度计算，所以合并后的总移动量与
+ * 逐个事件发送时相同。
+ */
+void
+sc_fpsgame_aim_accumulate(const struct sc_fpsgame_aim *aim, int32_t xrel,
+                          int32_t yrel, float ratio_x, float ratio_y,
+                          float *dx, float *dy);
+
+#endif
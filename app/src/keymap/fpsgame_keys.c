@@ -0,0 +1,402 @@
+#include "fpsgame_keys.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "util/log.h"
+
+#define SC_FPSGAME_CONFIG_LINE_MAX 256
+
+struct sc_fpsgame_default_binding {
+    // 旧配置格式中使用的名称，"<name>X" 和 "<name>Y" 设置其坐标
+    const char *name;
+    SDL_Scancode scancode; // SDL_SCANCODE_UNKNOWN 表示鼠标按键
+    uint8_t button;
+    uint8_t pointer_id;
+    float x;
+    float y;
+};
+
+static const struct sc_fpsgame_default_binding default_bindings[] = {
+    {"leftProbe",  SDL_SCANCODE_Q,      0, 3,  0.145f, 0.364f}, // 左探头
+    {"rightProbe", SDL_SCANCODE_E,      0, 3,  0.21f,  0.364f}, // 右探头
+    {"autoRun",    SDL_SCANCODE_EQUALS, 0, 3,  0.84f,  0.26f},  // 自动跑
+    {"jump",       SDL_SCANCODE_SPACE,  0, 11, 0.94f,  0.7f},   // 跳
+    {"map",        SDL_SCANCODE_M,      0, 10, 0.95f,  0.03f},  // 地图
+    {"knapsack",   SDL_SCANCODE_TAB,    0, 9,  0.09f,  0.9f},   // 背包
+    {"drop",       SDL_SCANCODE_Z,      0, 8,  0.91f,  0.9f},   // 趴
+    {"squat",      SDL_SCANCODE_C,      0, 7,  0.84f,  0.93f},  // 蹲
+    {"reload",     SDL_SCANCODE_R,      0, 6,  0.76f,  0.93f},  // 装弹
+    {"pickup1",    SDL_SCANCODE_F,      0, 3,  0.7f,   0.34f},  // 拾取1
+    {"pickup2",    SDL_SCANCODE_G,      0, 3,  0.7f,   0.44f},  // 拾取2
+    {"pickup3",    SDL_SCANCODE_H,      0, 3,  0.7f,   0.54f},  // 拾取3
+    {"switchGun1", SDL_SCANCODE_1,      0, 4,  0.45f,  0.9f},   // 换枪1
+    {"switchGun2", SDL_SCANCODE_2,      0, 5,  0.55f,  0.9f},   // 换枪2
+    {"medicine",   SDL_SCANCODE_3,      0, 3,  0.35f,  0.95f},  // 打药
+    {"frag",       SDL_SCANCODE_4,      0, 3,  0.65f,  0.92f},  // 手雷
+    {"getOffCar",  SDL_SCANCODE_5,      0, 3,  0.92f,  0.4f},   // 下车
+    {"help",       SDL_SCANCODE_6,      0, 3,  0.49f,  0.63f},  // 救人
+    {"getOnCar",   SDL_SCANCODE_7,      0, 3,  0.7f,   0.54f},  // 上车
+    {"openDoor",   SDL_SCANCODE_X,      0, 3,  0.7f,   0.7f},   // 开门
+    {"lickBag",    SDL_SCANCODE_T,      0, 3,  0.7f,   0.25f},  // 舔包
+    {"punctuation", SDL_SCANCODE_B,     0, 3,  0.888f, 0.338f}, // 标点
+    {"fire",  SDL_SCANCODE_UNKNOWN, SDL_BUTTON_LEFT,   12, 0.86f,  0.72f},  // 开火
+    {"openMirror", SDL_SCANCODE_UNKNOWN, SDL_BUTTON_RIGHT, 13, 0.94f, 0.52f}, // 开镜
+    {"punctuation", SDL_SCANCODE_UNKNOWN, SDL_BUTTON_MIDDLE, 14, 0.888f, 0.338f}, // 万能标点
+};
+
+static const struct {
+    const char *name;
+    size_t offset;
+} float_settings[] = {
+    {"pointX",           offsetof(struct sc_fpsgame_keys, pointX)},
+    {"pointY",           offsetof(struct sc_fpsgame_keys, pointY)},
+    {"speedRatioX",      offsetof(struct sc_fpsgame_keys, speedRatioX)},
+    {"speedRatioY",      offsetof(struct sc_fpsgame_keys, speedRatioY)},
+    {"wheelCenterposX",  offsetof(struct sc_fpsgame_keys, wheelCenterposX)},
+    {"wheelCenterposY",  offsetof(struct sc_fpsgame_keys, wheelCenterposY)},
+    {"wheelLeftOffset",  offsetof(struct sc_fpsgame_keys, wheelLeftOffset)},
+    {"wheelRightOffset", offsetof(struct sc_fpsgame_keys, wheelRightOffset)},
+    {"wheelUpOffset",    offsetof(struct sc_fpsgame_keys, wheelUpOffset)},
+    {"wheeldownOffset",  offsetof(struct sc_fpsgame_keys, wheeldownOffset)},
+};
+
+static const char *const mouse_button_names[SC_FPSGAME_MOUSE_BUTTONS] = {
+    [SDL_BUTTON_LEFT] = "MouseLeft",
+    [SDL_BUTTON_MIDDLE] = "MouseMiddle",
+    [SDL_BUTTON_RIGHT] = "MouseRight",
+    [SDL_BUTTON_X1] = "MouseX1",
+    [SDL_BUTTON_X2] = "MouseX2",
+};
+
+static struct sc_fpsgame_binding *
+get_default_binding(struct sc_fpsgame_keys *sfk,
+                    const struct sc_fpsgame_default_binding *def) {
+    if (def->scancode != SDL_SCANCODE_UNKNOWN) {
+        return &sfk->keys[def->scancode];
+    }
+    assert(def->button && def->button < SC_FPSGAME_MOUSE_BUTTONS);
+    return &sfk->buttons[def->button];
+}
+
+static void
+set_joystick(struct sc_fpsgame_keys *sfk, SDL_Scancode scancode,
+             int8_t axis_x, int8_t axis_y) {
+    struct sc_fpsgame_binding *b = &sfk->keys[scancode];
+    b->action = SC_FPSGAME_ACTION_JOYSTICK;
+    b->pointer_id = SC_FPSGAME_POINTER_WHEEL;
+    b->axis_x = axis_x;
+    b->axis_y = axis_y;
+}
+
+void
+sc_fpsgame_keys_init(struct sc_fpsgame_keys *sfk) {
+    memset(sfk, 0, sizeof(*sfk));
+
+    sfk->pointX = 0.55f; // 初始视角点
+    sfk->pointY = 0.4f;
+    sfk->aimX = sfk->pointX;
+    sfk->aimY = sfk->pointY;
+    sfk->aimPointer = SC_FPSGAME_POINTER_AIM;
+    sfk->speedRatioX = 0.00025f; // 鼠标速度
+    sfk->speedRatioY = 0.0006f;
+    sfk->wheelCenterposX = 0.20f; // 方向轮盘中心点
+    sfk->wheelCenterposY = 0.75f;
+    sfk->wheelLeftOffset = 0.1f; // 上下左右滑动的距离
+    sfk->wheelRightOffset = 0.1f;
+    sfk->wheelUpOffset = 0.24f;
+    sfk->wheeldownOffset = 0.2f;
+    sc_fpsgame_aim_init(&sfk->aim);
+
+    set_joystick(sfk, SDL_SCANCODE_W, 0, -1); // 前进
+    set_joystick(sfk, SDL_SCANCODE_S, 0, 1); // 后退
+    set_joystick(sfk, SDL_SCANCODE_A, -1, 0); // 左
+    set_joystick(sfk, SDL_SCANCODE_D, 1, 0); // 右
+
+    for (size_t i = 0; i < ARRAY_LEN(default_bindings); ++i) {
+        const struct sc_fpsgame_default_binding *def = &default_bindings[i];
+        struct sc_fpsgame_binding *b = get_default_binding(sfk, def);
+        b->action = SC_FPSGAME_ACTION_HOLD;
+        b->pointer_id = def->pointer_id;
+        b->x = def->x;
+        b->y = def->y;
+    }
+}
+
+static char *
+trim(char *s) {
+    while (*s == ' ' || *s == '\t') {
+        ++s;
+    }
+    size_t len = strlen(s);
+    while (len && strchr(" \t\r\n", s[len - 1])) {
+        s[--len] = '\0';
+    }
+    return s;
+}
+
+static struct sc_fpsgame_binding *
+find_binding(struct sc_fpsgame_keys *sfk, const char *name) {
+    for (unsigned i = 1; i < SC_FPSGAME_MOUSE_BUTTONS; ++i) {
+        if (mouse_button_names[i] && !strcmp(name, mouse_button_names[i])) {
+            return &sfk->buttons[i];
+        }
+    }
+
+    SDL_Scancode scancode = SDL_GetScancodeFromName(name);
+    if (scancode == SDL_SCANCODE_UNKNOWN) {
+        return NULL;
+    }
+    assert(scancode < SDL_NUM_SCANCODES);
+    return &sfk->keys[scancode];
+}
+
+static bool
+parse_action(const char *s, enum sc_fpsgame_action *action) {
+    if (!strcmp(s, "none")) {
+        *action = SC_FPSGAME_ACTION_NONE;
+    } else if (!strcmp(s, "tap")) {
+        *action = SC_FPSGAME_ACTION_TAP;
+    } else if (!strcmp(s, "hold")) {
+        *action = SC_FPSGAME_ACTION_HOLD;
+    } else if (!strcmp(s, "toggle")) {
+        *action = SC_FPSGAME_ACTION_TOGGLE;
+    } else if (!strcmp(s, "joystick")) {
+        *action = SC_FPSGAME_ACTION_JOYSTICK;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool
+parse_bind(struct sc_fpsgame_keys *sfk, const char *name, const char *value) {
+    struct sc_fpsgame_binding *b = find_binding(sfk, name);
+    if (!b) {
+        LOGW("Unknown key: \"%s\"", name);
+        return false;
+    }
+
+    char action_name[16];
+    int n = 0;
+    if (sscanf(value, "%15s%n", action_name, &n) != 1) {
+        LOGW("Missing action for key \"%s\"", name);
+        return false;
+    }
+
+    enum sc_fpsgame_action action;
+    if (!parse_action(action_name, &action)) {
+        LOGW("Unknown action for key \"%s\": \"%s\"", name, action_name);
+        return false;
+    }
+
+    const char *args = value + n;
+    struct sc_fpsgame_binding binding = {
+        .action = action,
+    };
+
+    switch (action) {
+        case SC_FPSGAME_ACTION_NONE:
+            break;
+        case SC_FPSGAME_ACTION_JOYSTICK: {
+            int axis_x;
+            int axis_y;
+            if (sscanf(args, "%d %d", &axis_x, &axis_y) != 2
+                    || axis_x < -1 || axis_x > 1
+                    || axis_y < -1 || axis_y > 1) {
+                LOGW("Invalid joystick axis for key \"%s\": \"%s\"", name,
+                     args);
+                return false;
+            }
+            binding.pointer_id = SC_FPSGAME_POINTER_WHEEL;
+            binding.axis_x = axis_x;
+            binding.axis_y = axis_y;
+            break;
+        }
+        default: {
+            float x;
+            float y;
+            unsigned pointer_id;
+            if (sscanf(args, "%f %f %u", &x, &y, &pointer_id) != 3
+                    || pointer_id > UINT8_MAX) {
+                LOGW("Invalid binding for key \"%s\": \"%s\"", name, args);
+                return false;
+            }
+            binding.pointer_id = pointer_id;
+            binding.x = x;
+            binding.y = y;
+            break;
+        }
+    }
+
+    *b = binding;
+    return true;
+}
+
+static bool
+parse_setting(struct sc_fpsgame_keys *sfk, const char *key, const char *value) {
+    if (!strncmp(key, "aim", 3) || !strncmp(key, "ads", 3)) {
+        return sc_fpsgame_aim_parse_setting(&sfk->aim, key, value);
+    }
+
+    float f;
+    if (sscanf(value, "%f", &f) != 1) {
+        LOGW("Invalid value for \"%s\": \"%s\"", key, value);
+        return false;
+    }
+
+    for (size_t i = 0; i < ARRAY_LEN(float_settings); ++i) {
+        if (!strcmp(key, float_settings[i].name)) {
+            float *field = (float *) ((char *) sfk + float_settings[i].offset);
+            *field = f;
+            return true;
+        }
+    }
+
+    // "<name>X" or "<name>Y" of a default binding
+    size_t len = strlen(key);
+    char axis = len ? key[len - 1] : '\0';
+    if (axis != 'X' && axis != 'Y') {
+        LOGW("Unknown setting: \"%s\"", key);
+        return false;
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < ARRAY_LEN(default_bindings); ++i) {
+        const struct sc_fpsgame_default_binding *def = &default_bindings[i];
+        if (strlen(def->name) == len - 1 && !strncmp(key, def->name, len - 1)) {
+            struct sc_fpsgame_binding *b = get_default_binding(sfk, def);
+            if (axis == 'X') {
+                b->x = f;
+            } else {
+                b->y = f;
+            }
+            found = true;
+        }
+    }
+
+    if (!found) {
+        LOGW("Unknown setting: \"%s\"", key);
+    }
+    return found;
+}
+
+bool
+sc_fpsgame_keys_parse_line(struct sc_fpsgame_keys *sfk, const char *line) {
+    char buf[SC_FPSGAME_CONFIG_LINE_MAX];
+    size_t len = strlen(line);
+    if (len >= sizeof(buf)) {
+        LOGW("Config line too long");
+        return false;
+    }
+    memcpy(buf, line, len + 1);
+
+    char *s = trim(buf);
+    if (!*s || *s == '#') {
+        return true;
+    }
+
+    char *sep = strchr(s, ':');
+    if (!sep) {
+        LOGW("Invalid config line: \"%s\"", s);
+        return false;
+    }
+    *sep = '\0';
+
+    char *key = trim(s);
+    char *value = trim(sep + 1);
+
+    if (!strncmp(key, "bind.", 5)) {
+        return parse_bind(sfk, key + 5, value);
+    }
+
+    return parse_setting(sfk, key, value);
+}
+
+struct sc_size
+sc_fpsgame_keys_get_oriented_size(struct sc_size frame_size,
+                                  enum sc_orientation orientation) {
+    struct sc_size size;
+    if (sc_orientation_is_swap(orientation)) {
+        size.width = frame_size.height;
+        size.height = frame_size.width;
+    } else {
+        size = frame_size;
+    }
+    return size;
+}
+
+struct sc_point
+sc_fpsgame_keys_to_frame_point(struct sc_size frame_size,
+                               enum sc_orientation orientation,
+                               float x, float y) {
+    struct sc_size size =
+        sc_fpsgame_keys_get_oriented_size(frame_size, orientation);
+    int32_t w = size.width;
+    int32_t h = size.height;
+
+    // 四舍五入到最近的像素
+    int32_t px = x * w + 0.5f;
+    int32_t py = y * h + 0.5f;
+
+    struct sc_point result;
+    switch (orientation) {
+        case SC_ORIENTATION_0:
+            result.x = px;
+            result.y = py;
+            break;
+        case SC_ORIENTATION_90:
+            result.x = py;
+            result.y = w - px;
+            break;
+        case SC_ORIENTATION_180:
+            result.x = w - px;
+            result.y = h - py;
+            break;
+        case SC_ORIENTATION_270:
+            result.x = h - py;
+            result.y = px;
+            break;
+        case SC_ORIENTATION_FLIP_0:
+            result.x = w - px;
+            result.y = py;
+            break;
+        case SC_ORIENTATION_FLIP_90:
+            result.x = h - py;
+            result.y = w - px;
+            break;
+        case SC_ORIENTATION_FLIP_180:
+            result.x = px;
+            result.y = h - py;
+            break;
+        default:
+            assert(orientation == SC_ORIENTATION_FLIP_270);
+            result.x = py;
+            result.y = px;
+            break;
+    }
+    return result;
+}
+
+bool
+sc_fpsgame_keys_load(struct sc_fpsgame_keys *sfk, const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (!file) {
+        LOGI("Could not open %s, using default key bindings", filename);
+        return false;
+    }
+
+    char line[SC_FPSGAME_CONFIG_LINE_MAX];
+    unsigned lineno = 0;
+    while (fgets(line, sizeof(line), file)) {
+        ++lineno;
+        if (!sc_fpsgame_keys_parse_line(sfk, line)) {
+            LOGW("%s:%u: line ignored", filename, lineno);
+        }
+    }
+
+    fclose(file);
+    return true;
+}
@@ -1,9 +1,56 @@
+#ifndef SC_FPSGAME_KEYS_H
+#define SC_FPSGAME_KEYS_H
 
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <SDL2/SDL_mouse.h>
+#include <SDL2/SDL_scancode.h>
+
+#include "coords.h"
+#include "options.h"
+#include "keymap/fpsgame_aim.h"
+
+#define SC_FPSGAME_CONFIG_FILENAME "fps_game_config.txt"
+
+// 鼠标按键的数量（SDL_BUTTON_LEFT..SDL_BUTTON_X2，下标 0 不使用）
+#define SC_FPSGAME_MOUSE_BUTTONS (SDL_BUTTON_X2 + 1)
+
+// 方向轮盘和视角使用的固定手指
+#define SC_FPSGAME_POINTER_WHEEL 1
+#define SC_FPSGAME_POINTER_AIM 2
+// 视角回中时与 SC_FPSGAME_POINTER_AIM 交替使用
+#define SC_FPSGAME_POINTER_AIM_ALT 0
+
+enum sc_fpsgame_action {
+    SC_FPSGAME_ACTION_NONE, // 未绑定
+    SC_FPSGAME_ACTION_TAP, // 按下时点击一次（按下+抬起）
+    SC_FPSGAME_ACTION_HOLD, // 按住期间保持按下
+    SC_FPSGAME_ACTION_TOGGLE, // 每次按下切换按下/抬起状态
+    SC_FPSGAME_ACTION_JOYSTICK, // 方向轮盘的一个方向
+};
+
+// 一个按键（或鼠标按键）的绑定，所有坐标都归一化到 [0, 1]
+struct sc_fpsgame_binding {
+    uint8_t action; // enum sc_fpsgame_action
+    uint8_t pointer_id;
+    // 仅用于 SC_FPSGAME_ACTION_JOYSTICK：方向轮盘上的方向（-1、0 或 1）
+    int8_t axis_x;
+    int8_t axis_y;
+    // SC_FPSGAME_ACTION_TOGGLE 的当前状态
+    bool toggled;
+    float x;
+    float y;
+};
 
 struct sc_fpsgame_keys {
-    float pointX;
+    float pointX; // 视角中心点，视角手指在这里按下
     float pointY;
-    Sint32 rouletteX;
+    float aimX; // 视角手指的当前位置
+    float aimY;
+    uint8_t aimPointer; // 视角手指当前使用的手指id
+    Sint32 rouletteX; // 方向轮盘当前方向（按下的方向键之和）
     Sint32 rouletteY;
     float speedRatioX;
     float speedRatioY;
@@ -13,52 +60,56 @@ struct sc_fpsgame_keys {
     float wheelRightOffset;
     float wheelUpOffset;
     float wheeldownOffset;
-    float leftProbeX;
-    float leftProbeY;
-    float rightProbeX;
-    float rightProbeY;
-    float autoRunX;
-    float autoRunY;
-    float jumpX;
-    float jumpY;
-    float mapX;
-    float mapY;
-    float knapsackX;
-    float knapsackY;
-    float dropX;
-    float dropY;
-    float squatX;
-    float squatY;
-    float reloadX;
-    float reloadY;
-    float pickup1X;
-    float pickup1Y;
-    float pickup2X;
-    float pickup2Y;
-    float pickup3X;
-    float pickup3Y;
-    float switchGun1X;
-    float switchGun1Y;
-    float switchGun2X;
-    float switchGun2Y;
-    float fragX;
-    float fragY;
-    float medicineX;
-    float medicineY;
-    float getOffCarX;
-    float getOffCarY;
-    float getOnCarX;
-    float getOnCarY;
-    float helpX;
-    float helpY;
-    float openDoorX;
-    float openDoorY;
-    float lickBagX;
-    float lickBagY;
-    float fireX;
-    float fireY;
-    float openMirrorX;
-    float openMirrorY;
-    float punctuationX;
-    float punctuationY;
-};
\ No newline at end of file
+
+    // 鼠标移动到视角点移动的转换（灵敏度曲线、开镜灵敏度）
+    struct sc_fpsgame_aim aim;
+
+    // 以 SDL scancode 为下标，每次按键只需一次查表
+    struct sc_fpsgame_binding keys[SDL_NUM_SCANCODES];
+    // 以 SDL 鼠标按键编号为下标
+    struct sc_fpsgame_binding buttons[SC_FPSGAME_MOUSE_BUTTONS];
+};
+
+// 初始化为默认按键布局
+void
+sc_fpsgame_keys_init(struct sc_fpsgame_keys *sfk);
+
+/**
+ * 解析配置文件中的一行
+ *
+ * 支持的格式：
+ *  - "<设置>:<值>"，例如 "speedRatioX:0.00025"
+ *  - "<名称>X:<值>" / "<名称>Y:<值>"，移动默认绑定的位置，例如 "jumpX:0.94"
+ *  - "bind.<按键>:<动作> <x> <y> <手指id>"，绑定任意按键，其中 <按键> 是 SDL
+ *    scancode 名称（"Space"、"Left Shift"……）或 "MouseLeft"、"MouseMiddle"、
+ *    "MouseRight"、"MouseX1"、"MouseX2"，<动作> 是 "tap"、"hold" 或 "toggle"
+ *  - "bind.<按键>:joystick <axis_x> <axis_y>"，绑定方向轮盘的一个方向
+ *  - "bind.<按键>:none"，取消绑定
+ *  - 以 "aim" 或 "ads" 开头的设置，见 sc_fpsgame_aim_parse_setting()
+ *
+ * 空行和以 '#' 开头的行会被忽略。
+ */
+bool
+sc_fpsgame_keys_parse_line(struct sc_fpsgame_keys *sfk, const char *line);
+
+// 旋转后的整个画面大小，归一化坐标以它为单位
+struct sc_size
+sc_fpsgame_keys_get_oriented_size(struct sc_size frame_size,
+                                  enum sc_orientation orientation);
+
+/**
+ * 把归一化到 [0, 1] 的坐标转换为设备画面上的像素坐标（四舍五入）
+ *
+ * 坐标相对于按 orientation 旋转后的整个画面，与窗口中显示的区域
+ * （--render-roi）无关，切换 ROI 时按键位置不变。
+ */
+struct sc_point
+sc_fpsgame_keys_to_frame_point(struct sc_size frame_size,
+                               enum sc_orientation orientation,
+                               float x, float y);
+
+// 读取配置文件，文件不存在时保留当前配置
+bool
+sc_fpsgame_keys_load(struct sc_fpsgame_keys *sfk, const char *filename);
+
+#endif
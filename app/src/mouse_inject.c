@@ -139,7 +139,8 @@ sc_mouse_processor_process_touch(struct sc_mouse_processor *mp,
         },
     };
 
-    if (!sc_controller_push_msg(mi->controller, &msg)) {
+    sc_tick timestamp = event->timestamp ? event->timestamp : sc_tick_now();
+    if (!sc_controller_push_msg_at(mi->controller, &msg, timestamp)) {
         LOGW("Could not request 'inject touch event'");
     }
 }
@@ -18,6 +18,21 @@ sc_opengl_init(struct sc_opengl *gl) {
     // optional
     gl->GenerateMipmap = SDL_GL_GetProcAddress("glGenerateMipmap");
 
+    // optional (PBO uploads)
+    gl->ActiveTexture = SDL_GL_GetProcAddress("glActiveTexture");
+    gl->PixelStorei = SDL_GL_GetProcAddress("glPixelStorei");
+    gl->TexSubImage2D = SDL_GL_GetProcAddress("glTexSubImage2D");
+    gl->GenBuffers = SDL_GL_GetProcAddress("glGenBuffers");
+    gl->DeleteBuffers = SDL_GL_GetProcAddress("glDeleteBuffers");
+    gl->BindBuffer = SDL_GL_GetProcAddress("glBindBuffer");
+    gl->BufferData = SDL_GL_GetProcAddress("glBufferData");
+    gl->BufferStorage = SDL_GL_GetProcAddress("glBufferStorage");
+    gl->MapBufferRange = SDL_GL_GetProcAddress("glMapBufferRange");
+    gl->UnmapBuffer = SDL_GL_GetProcAddress("glUnmapBuffer");
+    gl->FenceSync = SDL_GL_GetProcAddress("glFenceSync");
+    gl->ClientWaitSync = SDL_GL_GetProcAddress("glClientWaitSync");
+    gl->DeleteSync = SDL_GL_GetProcAddress("glDeleteSync");
+
     const char *version = (const char *) gl->GetString(GL_VERSION);
     assert(version);
     gl->version = version;
@@ -39,6 +54,20 @@ sc_opengl_init(struct sc_opengl *gl) {
     }
 }
 
+bool
+sc_opengl_has_pbo(struct sc_opengl *gl) {
+    // The functions may be exposed even if the context does not support them
+    if (!sc_opengl_version_at_least(gl, 3, 2, /* OpenGL 3.2+ */
+                                        3, 0  /* OpenGL ES 3.0+ */)) {
+        return false;
+    }
+
+    return gl->ActiveTexture && gl->PixelStorei && gl->TexSubImage2D
+        && gl->GenBuffers && gl->DeleteBuffers && gl->BindBuffer
+        && gl->BufferData && gl->MapBufferRange && gl->UnmapBuffer
+        && gl->FenceSync && gl->ClientWaitSync && gl->DeleteSync;
+}
+
 bool
 sc_opengl_version_at_least(struct sc_opengl *gl,
                            int minver_major, int minver_minor,
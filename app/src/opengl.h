@@ -23,11 +23,65 @@ struct sc_opengl {
 
     void
     (*GenerateMipmap)(GLenum target);
+
+    // Optional, for streaming texture uploads through pixel buffer objects
+    void
+    (*ActiveTexture)(GLenum texture);
+
+    void
+    (*PixelStorei)(GLenum pname, GLint param);
+
+    void
+    (*TexSubImage2D)(GLenum target, GLint level, GLint xoffset, GLint yoffset,
+                     GLsizei width, GLsizei height, GLenum format, GLenum type,
+                     const void *pixels);
+
+    void
+    (*GenBuffers)(GLsizei n, GLuint *buffers);
+
+    void
+    (*DeleteBuffers)(GLsizei n, const GLuint *buffers);
+
+    void
+    (*BindBuffer)(GLenum target, GLuint buffer);
+
+    void
+    (*BufferData)(GLenum target, GLsizeiptr size, const void *data,
+                  GLenum usage);
+
+    void
+    (*BufferStorage)(GLenum target, GLsizeiptr size, const void *data,
+                     GLbitfield flags);
+
+    void *
+    (*MapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length,
+                      GLbitfield access);
+
+    GLboolean
+    (*UnmapBuffer)(GLenum target);
+
+    GLsync
+    (*FenceSync)(GLenum condition, GLbitfield flags);
+
+    GLenum
+    (*ClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+
+    void
+    (*DeleteSync)(GLsync sync);
 };
 
 void
 sc_opengl_init(struct sc_opengl *gl);
 
+/**
+ * Return true if the functions required to upload textures through pixel
+ * buffer objects are available (OpenGL 3.2+ or OpenGL ES 3.0+)
+ *
+ * BufferStorage (persistent mapping) is only available from OpenGL 4.4.
+ */
+bool
+sc_opengl_has_pbo(struct sc_opengl *gl);
+
 bool
 sc_opengl_version_at_least(struct sc_opengl *gl,
                            int minver_major, int minver_minor,
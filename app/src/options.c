@@ -47,12 +47,14 @@ const struct scrcpy_options scrcpy_options_default = {
     .window_height = 0,
     .display_id = 0,
     .display_buffer = 0,
+    .display_buffer_max = 0,
     .audio_buffer = -1, // depends on the audio format,
-    .audio_output_buffer = SC_TICK_FROM_MS(5),
+    .audio_output_buffer = -1, // depends on audio_low_latency
     .time_limit = 0,
 #ifdef HAVE_V4L2
     .v4l2_device = NULL,
     .v4l2_buffer = 0,
+    .v4l2_buffer_max = 0,
 #endif
 #ifdef HAVE_USB
     .otg = false,
@@ -63,10 +65,12 @@ const struct scrcpy_options scrcpy_options_default = {
     .control = true,
     .video_playback = true,
     .audio_playback = true,
+    .audio_low_latency = false,
     .turn_screen_off = false,
     .key_inject_mode = SC_KEY_INJECT_MODE_MIXED,
     .window_borderless = false,
     .mipmaps = true,
+    .pbo = true,
     .stay_awake = false,
     .force_adb_forward = false,
     .disable_screensaver = false,
@@ -82,12 +86,28 @@ const struct scrcpy_options scrcpy_options_default = {
     .select_usb = false,
     .cleanup = true,
     .start_fps_counter = false,
+    .print_input_latency = false,
     .power_on = true,
     .video = true,
     .audio = true,
     .require_audio = false,
     .kill_adb_on_close = false,
     .camera_high_speed = false,
+    .tcp_nodelay = true,
+    .tune_video_socket = false,
+    .socket_send_buffer = 0,
+    .video_decoder_threads = 0,
+    .dump_stream = NULL,
+    .replay_stream = NULL,
+    .replay_fast = false,
+    .frame_policy = SC_FRAME_POLICY_LATEST,
+    .frame_ring_size = 0, // 0 means default (3 with SC_FRAME_POLICY_RING)
+    .render_roi = {
+        .width = 0,
+        .height = 0,
+        .x = -1,
+        .y = -1,
+    },
     .list = 0,
 };
 
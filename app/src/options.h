@@ -163,6 +163,19 @@ enum sc_key_inject_mode {
     SC_KEY_INJECT_MODE_RAW,
 };
 
+enum sc_frame_policy {
+    // Only keep the last decoded frame (minimal latency).
+    // This is the default policy.
+    SC_FRAME_POLICY_LATEST,
+
+    // Keep up to frame_ring_size frames, drop the oldest when full.
+    SC_FRAME_POLICY_RING,
+
+    // Like SC_FRAME_POLICY_LATEST, but do not decode the non-reference
+    // frames while the previous frame has not been rendered.
+    SC_FRAME_POLICY_DECODE_DROP,
+};
+
 #define SC_MAX_SHORTCUT_MODS 8
 
 enum sc_shortcut_mod {
@@ -184,6 +197,14 @@ struct sc_port_range {
     uint16_t last;
 };
 
+// Region of the frame to render (in pixels of the frame)
+struct sc_roi {
+    uint16_t width; // 0 to render the whole frame
+    uint16_t height;
+    int32_t x; // negative to center the region
+    int32_t y;
+};
+
 #define SC_WINDOW_POSITION_UNDEFINED (-0x8000)
 
 struct scrcpy_options {
@@ -227,12 +248,14 @@ struct scrcpy_options {
     uint16_t window_height;
     uint32_t display_id;
     sc_tick display_buffer;
+    sc_tick display_buffer_max; // adaptive if greater than display_buffer
     sc_tick audio_buffer;
     sc_tick audio_output_buffer;
     sc_tick time_limit;
 #ifdef HAVE_V4L2
     const char *v4l2_device;
     sc_tick v4l2_buffer;
+    sc_tick v4l2_buffer_max; // adaptive if greater than v4l2_buffer
 #endif
 #ifdef HAVE_USB
     bool otg;
@@ -243,10 +266,12 @@ struct scrcpy_options {
     bool control;
     bool video_playback;
     bool audio_playback;
+    bool audio_low_latency;
     bool turn_screen_off;
     enum sc_key_inject_mode key_inject_mode;
     bool window_borderless;
     bool mipmaps;
+    bool pbo;
     bool stay_awake;
     bool force_adb_forward;
     bool disable_screensaver;
@@ -262,12 +287,23 @@ struct scrcpy_options {
     bool select_tcpip;
     bool cleanup;
     bool start_fps_counter;
+    bool print_input_latency;
     bool power_on;
     bool video;
     bool audio;
     bool require_audio;
     bool kill_adb_on_close;
     bool camera_high_speed;
+    bool tcp_nodelay;
+    bool tune_video_socket;
+    uint32_t socket_send_buffer; // 0 for the system default
+    uint16_t video_decoder_threads; // 0 for automatic
+    const char *dump_stream;
+    const char *replay_stream;
+    bool replay_fast;
+    enum sc_frame_policy frame_policy;
+    uint8_t frame_ring_size;
+    struct sc_roi render_roi;
 #define SC_OPTION_LIST_ENCODERS 0x1
 #define SC_OPTION_LIST_DISPLAYS 0x2
 #define SC_OPTION_LIST_CAMERAS 0x4
@@ -0,0 +1,69 @@
+#ifndef SC_PACKET_HEADER_H
+#define SC_PACKET_HEADER_H
+
+#include "common.h"
+
+#include <stdint.h>
+#include <libavcodec/avcodec.h>
+
+/**
+ * The video and audio streams start with the codec id (4 bytes), followed by
+ * the video size for video streams (8 bytes), then contain a sequence of raw
+ * packets (as provided by MediaCodec), each prefixed with a "meta" header.
+ *
+ * The "meta" header length is 12 bytes:
+ * [. . . . . . . .|. . . .]. . . . . . . . . . . . . . . ...
+ *  <-------------> <-----> <-----------------------------...
+ *        PTS        packet        raw packet
+ *                    size
+ *
+ * It is followed by <packet_size> bytes containing the packet/frame.
+ *
+ * The most significant bits of the PTS are used for packet flags:
+ *
+ *  byte 7   byte 6   byte 5   byte 4   byte 3   byte 2   byte 1   byte 0
+ * CK...... ........ ........ ........ ........ ........ ........ ........
+ * ^^<------------------------------------------------------------------->
+ * ||                                PTS
+ * | `- key frame
+ *  `-- config packet
+ */
+
+#define SC_PACKET_HEADER_SIZE 12
+
+#define SC_PACKET_FLAG_CONFIG    (UINT64_C(1) << 63)
+#define SC_PACKET_FLAG_KEY_FRAME (UINT64_C(1) << 62)
+
+#define SC_PACKET_PTS_MASK (SC_PACKET_FLAG_KEY_FRAME - 1)
+
+#define SC_CODEC_ID_H264 UINT32_C(0x68323634) // "h264" in ASCII
+#define SC_CODEC_ID_H265 UINT32_C(0x68323635) // "h265" in ASCII
+#define SC_CODEC_ID_AV1 UINT32_C(0x00617631) // "av1" in ASCII
+#define SC_CODEC_ID_OPUS UINT32_C(0x6f707573) // "opus" in ASCII
+#define SC_CODEC_ID_AAC UINT32_C(0x00616163) // "aac" in ASCII
+#define SC_CODEC_ID_FLAC UINT32_C(0x666c6163) // "flac" in ASCII
+#define SC_CODEC_ID_RAW UINT32_C(0x00726177) // "raw" in ASCII
+
+/**
+ * Convert a codec id received from the device
+ *
+ * Return AV_CODEC_ID_NONE (and log an error) if it is not supported.
+ */
+enum AVCodecID
+sc_packet_header_to_avcodec_id(uint32_t codec_id);
+
+/**
+ * Read a packet header
+ *
+ * Return the packet size, and store the PTS and flags in *pts_flags.
+ */
+uint32_t
+sc_packet_header_read(const uint8_t *header, uint64_t *pts_flags);
+
+/**
+ * Set the PTS, DTS and flags of a packet from the header PTS and flags
+ */
+void
+sc_packet_header_apply(AVPacket *packet, uint64_t pts_flags);
+
+#endif
@@ -9,7 +9,19 @@ sc_packet_merger_init(struct sc_packet_merger *merger) {
 
 void
 sc_packet_merger_destroy(struct sc_packet_merger *merger) {
-    free(merger->config);
+    av_buffer_unref(&merger->config);
+}
+
+size_t
+sc_packet_merger_get_headroom(const struct sc_packet_merger *merger) {
+    return merger->config ? merger->config_size : 0;
+}
+
+static bool
+sc_packet_merger_has_headroom(AVPacket *packet, size_t size) {
+    return packet->buf
+        && (size_t) (packet->data - packet->buf->data) >= size
+        && av_buffer_is_writable(packet->buf);
 }
 
 bool
@@ -17,31 +29,46 @@ sc_packet_merger_merge(struct sc_packet_merger *merger, AVPacket *packet) {
     bool is_config = packet->pts == AV_NOPTS_VALUE;
 
     if (is_config) {
-        free(merger->config);
+        av_buffer_unref(&merger->config);
+
+        // Keep a reference to the packet buffer rather than a copy
+        if (av_packet_make_refcounted(packet)) {
+            LOG_OOM();
+            return false;
+        }
 
-        merger->config = malloc(packet->size);
+        merger->config = av_buffer_ref(packet->buf);
         if (!merger->config) {
             LOG_OOM();
             return false;
         }
 
-        memcpy(merger->config, packet->data, packet->size);
+        merger->config_data = packet->data;
         merger->config_size = packet->size;
     } else if (merger->config) {
         size_t config_size = merger->config_size;
-        size_t media_size = packet->size;
 
-        if (av_grow_packet(packet, config_size)) {
-            LOG_OOM();
-            return false;
+        if (sc_packet_merger_has_headroom(packet, config_size)) {
+            // The payload was received after some reserved space, so just
+            // fill it
+            packet->data -= config_size;
+            packet->size += config_size;
+        } else {
+            size_t media_size = packet->size;
+
+            if (av_grow_packet(packet, config_size)) {
+                LOG_OOM();
+                return false;
+            }
+
+            memmove(packet->data + config_size, packet->data, media_size);
         }
 
-        memmove(packet->data + config_size, packet->data, media_size);
-        memcpy(packet->data, merger->config, config_size);
+        memcpy(packet->data, merger->config_data, config_size);
 
-        free(merger->config);
-        merger->config = NULL;
-        // merger->size is meaningless when merger->config is NULL
+        av_buffer_unref(&merger->config);
+        // merger->config_data and merger->config_size are meaningless when
+        // merger->config is NULL
     }
 
     return true;
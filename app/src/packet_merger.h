@@ -21,7 +21,9 @@
  */
 
 struct sc_packet_merger {
-    uint8_t *config;
+    // Reference to the pending config packet payload (not copied)
+    AVBufferRef *config;
+    const uint8_t *config_data;
     size_t config_size;
 };
 
@@ -31,11 +33,24 @@ sc_packet_merger_init(struct sc_packet_merger *merger);
 void
 sc_packet_merger_destroy(struct sc_packet_merger *merger);
 
+/**
+ * Return the number of bytes to reserve before the payload of the next media
+ * packet, so that the pending config packet can be prepended in place
+ *
+ * Return 0 if no config packet is pending.
+ */
+size_t
+sc_packet_merger_get_headroom(const struct sc_packet_merger *merger);
+
 /**
  * If the packet is a config packet, then keep its data for later.
  * Otherwise (if the packet is a media packet), then if a config packet is
  * pending, prepend the config packet to this packet (so the packet is
  * modified!).
+ *
+ * If the media packet buffer has enough writable headroom before its data
+ * (see sc_packet_merger_get_headroom()), the config is copied there and the
+ * media payload is not moved.
  */
 bool
 sc_packet_merger_merge(struct sc_packet_merger *merger, AVPacket *packet);
@@ -0,0 +1,91 @@
+#include "packet_pool.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "util/log.h"
+
+void
+sc_packet_pool_init(struct sc_packet_pool *pool) {
+    for (unsigned i = 0; i < SC_PACKET_POOL_CLASSES; ++i) {
+        pool->pools[i] = NULL;
+    }
+    pool->hits = 0;
+    pool->misses = 0;
+}
+
+void
+sc_packet_pool_destroy(struct sc_packet_pool *pool) {
+    for (unsigned i = 0; i < SC_PACKET_POOL_CLASSES; ++i) {
+        // No-op if NULL
+        av_buffer_pool_uninit(&pool->pools[i]);
+    }
+}
+
+static AVBufferRef *
+#ifdef SCRCPY_LAVU_HAS_BUFFER_SIZE_T
+sc_packet_pool_alloc(void *opaque, size_t size) {
+#else
+sc_packet_pool_alloc(void *opaque, int size) {
+#endif
+    // Only called when the pool has no buffer available
+    struct sc_packet_pool *pool = opaque;
+    ++pool->misses;
+    return av_buffer_alloc(size);
+}
+
+static unsigned
+sc_packet_pool_get_class(size_t size) {
+    unsigned shift = SC_PACKET_POOL_MIN_SHIFT;
+    while (((size_t) 1 << shift) < size) {
+        ++shift;
+    }
+    return shift - SC_PACKET_POOL_MIN_SHIFT;
+}
+
+bool
+sc_packet_pool_new_packet(struct sc_packet_pool *pool, AVPacket *packet,
+                          size_t headroom, size_t size) {
+    assert(!packet->buf);
+
+    size_t alloc_size = headroom + size + AV_INPUT_BUFFER_PADDING_SIZE;
+    if (alloc_size > (size_t) 1 << SC_PACKET_POOL_MAX_SHIFT) {
+        ++pool->misses;
+        if (av_new_packet(packet, headroom + size)) {
+            return false;
+        }
+        packet->data += headroom;
+        packet->size = size;
+        return true;
+    }
+
+    unsigned index = sc_packet_pool_get_class(alloc_size);
+    AVBufferPool **bp = &pool->pools[index];
+    if (!*bp) {
+        size_t class_size = (size_t) 1 << (index + SC_PACKET_POOL_MIN_SHIFT);
+        *bp = av_buffer_pool_init2(class_size, pool, sc_packet_pool_alloc,
+                                   NULL);
+        if (!*bp) {
+            return false;
+        }
+    }
+
+    uint64_t misses = pool->misses;
+    AVBufferRef *buf = av_buffer_pool_get(*bp);
+    if (!buf) {
+        return false;
+    }
+
+    if (pool->misses == misses) {
+        ++pool->hits;
+    }
+
+    // The whole buffer remains available, so av_grow_packet() (used by the
+    // packet merger) may grow the packet in place
+    packet->buf = buf;
+    packet->data = buf->data + headroom;
+    packet->size = size;
+    memset(packet->data + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+    return true;
+}
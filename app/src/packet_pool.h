@@ -0,0 +1,61 @@
+#ifndef SC_PACKET_POOL_H
+#define SC_PACKET_POOL_H
+
+#include "common.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+
+// Size classes are powers of two, from 4 KiB to 16 MiB
+#define SC_PACKET_POOL_MIN_SHIFT 12
+#define SC_PACKET_POOL_MAX_SHIFT 24
+#define SC_PACKET_POOL_CLASSES \
+    (SC_PACKET_POOL_MAX_SHIFT - SC_PACKET_POOL_MIN_SHIFT + 1)
+
+/**
+ * Recycle the packet buffers allocated by the demuxer.
+ *
+ * The packet data is stored in refcounted buffers taken from an AVBufferPool
+ * per size class. Once the demuxer and all the sinks have released their
+ * references (via av_packet_unref()), the buffer returns to its pool instead
+ * of being freed, so that the next packet of a similar size reuses it.
+ *
+ * Packets larger than the biggest class are allocated with av_new_packet().
+ *
+ * The pool must be used from a single thread (the demuxer thread), but the
+ * buffers may be released from any thread.
+ */
+struct sc_packet_pool {
+    AVBufferPool *pools[SC_PACKET_POOL_CLASSES]; // created on first use
+
+    uint64_t hits; // buffers reused from a pool
+    uint64_t misses; // buffers newly allocated
+};
+
+void
+sc_packet_pool_init(struct sc_packet_pool *pool);
+
+/**
+ * Release the pools
+ *
+ * The buffers still referenced by packets remain valid: each pool is actually
+ * freed once all its buffers have been released.
+ */
+void
+sc_packet_pool_destroy(struct sc_packet_pool *pool);
+
+/**
+ * Allocate the payload of an empty packet, like av_new_packet()
+ *
+ * The payload starts after `headroom` bytes reserved at the beginning of the
+ * buffer, so that data may later be prepended without moving the payload.
+ *
+ * The AV_INPUT_BUFFER_PADDING_SIZE bytes following the payload are zeroed.
+ */
+bool
+sc_packet_pool_new_packet(struct sc_packet_pool *pool, AVPacket *packet,
+                          size_t headroom, size_t size);
+
+#endif
@@ -15,6 +15,7 @@ sc_receiver_init(struct sc_receiver *receiver, sc_socket control_socket,
     }
 
     receiver->control_socket = control_socket;
+    receiver->quickack = false;
     receiver->acksync = acksync;
 
     return true;
@@ -90,6 +91,11 @@ run_receiver(void *data) {
             break;
         }
 
+        if (receiver->quickack) {
+            // Stop re-arming on error, it would fail every time
+            receiver->quickack = net_set_quickack(receiver->control_socket);
+        }
+
         head += r;
         ssize_t consumed = process_msgs(receiver, buf, head);
         if (consumed == -1) {
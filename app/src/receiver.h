@@ -13,6 +13,8 @@
 // managed by the controller
 struct sc_receiver {
     sc_socket control_socket;
+    // Re-arm TCP_QUICKACK after each receive
+    bool quickack;
     sc_thread thread;
     sc_mutex mutex;
 
@@ -347,329 +347,6 @@ scrcpy_generate_scid(void)
     return sc_rand_u32(&rand) & 0x7FFFFFFF;
 }
 
-static int
-load_fpsgame_config(struct sc_fpsgame_keys *sfk)
-{
-    FILE *file = fopen("fps_game_config.txt", "r");
-    if (file == NULL)
-    {
-        LOGI("Error opening fps_game_config.txt");
-        return 1;
-    }
-
-    char line[100];
-
-    while (fgets(line, sizeof(line), file) != NULL)
-    {
-        char key[50], value[50];
-        if (sscanf(line, "%49[^:]: %49s", key, value) == 2)
-        {
-            printf(">>%s==%s<<\n", key, value);
-
-            if (!strcmp(key, "pointX"))
-            {
-                sfk->pointX = atof(value);
-            }
-            else if (!strcmp(key, "pointY"))
-            {
-                sfk->pointY = atof(value);
-            }
-            else if (!strcmp(key, "speedRatioX"))
-            {
-                sfk->speedRatioX = atof(value);
-            }
-            else if (!strcmp(key, "speedRatioY"))
-            {
-                sfk->speedRatioY = atof(value);
-            }
-            else if (!strcmp(key, "wheelCenterposX"))
-            {
-                sfk->wheelCenterposX = atof(value);
-            }
-            else if (!strcmp(key, "wheelCenterposY"))
-            {
-                sfk->wheelCenterposY = atof(value);
-            }
-            else if (!strcmp(key, "wheelLeftOffset"))
-            {
-                sfk->wheelLeftOffset = atof(value);
-            }
-            else if (!strcmp(key, "wheelRightOffset"))
-            {
-                sfk->wheelRightOffset = atof(value);
-            }
-            else if (!strcmp(key, "wheelUpOffset"))
-            {
-                sfk->wheelUpOffset = atof(value);
-            }
-            else if (!strcmp(key, "wheeldownOffset"))
-            {
-                sfk->wheeldownOffset = atof(value);
-            }
-            else if (!strcmp(key, "leftProbeX"))
-            {
-                sfk->leftProbeX = atof(value);
-            }
-            else if (!strcmp(key, "leftProbeY"))
-            {
-                sfk->leftProbeY = atof(value);
-            }
-            else if (!strcmp(key, "rightProbeX"))
-            {
-                sfk->rightProbeX = atof(value);
-            }
-            else if (!strcmp(key, "rightProbeY"))
-            {
-                sfk->rightProbeY = atof(value);
-            }
-            else if (!strcmp(key, "autoRunX"))
-            {
-                sfk->autoRunX = atof(value);
-            }
-            else if (!strcmp(key, "autoRunY"))
-            {
-                sfk->autoRunY = atof(value);
-            }
-            else if (!strcmp(key, "jumpX"))
-            {
-                sfk->jumpX = atof(value);
-            }
-            else if (!strcmp(key, "jumpY"))
-            {
-                sfk->jumpY = atof(value);
-            }
-            else if (!strcmp(key, "mapX"))
-            {
-                sfk->mapX = atof(value);
-            }
-            else if (!strcmp(key, "mapY"))
-            {
-                sfk->mapY = atof(value);
-            }
-            else if (!strcmp(key, "knapsackX"))
-            {
-                sfk->knapsackX = atof(value);
-            }
-            else if (!strcmp(key, "knapsackY"))
-            {
-                sfk->knapsackY = atof(value);
-            }
-            else if (!strcmp(key, "dropX"))
-            {
-                sfk->dropX = atof(value);
-            }
-            else if (!strcmp(key, "dropY"))
-            {
-                sfk->dropY = atof(value);
-            }
-            else if (!strcmp(key, "squatX"))
-            {
-                sfk->squatX = atof(value);
-            }
-            else if (!strcmp(key, "squatY"))
-            {
-                sfk->squatY = atof(value);
-            }
-            else if (!strcmp(key, "reloadX"))
-            {
-                sfk->reloadX = atof(value);
-            }
-            else if (!strcmp(key, "reloadY"))
-            {
-                sfk->reloadY = atof(value);
-            }
-            else if (!strcmp(key, "pickup1X"))
-            {
-                sfk->pickup1X = atof(value);
-            }
-            else if (!strcmp(key, "pickup1Y"))
-            {
-                sfk->pickup1Y = atof(value);
-            }
-            else if (!strcmp(key, "pickup2X"))
-            {
-                sfk->pickup2X = atof(value);
-            }
-            else if (!strcmp(key, "pickup2Y"))
-            {
-                sfk->pickup2Y = atof(value);
-            }
-            else if (!strcmp(key, "pickup3X"))
-            {
-                sfk->pickup3X = atof(value);
-            }
-            else if (!strcmp(key, "pickup3Y"))
-            {
-                sfk->pickup3Y = atof(value);
-            }
-            else if (!strcmp(key, "switchGun1X"))
-            {
-                sfk->switchGun1X = atof(value);
-            }
-            else if (!strcmp(key, "switchGun1Y"))
-            {
-                sfk->switchGun1Y = atof(value);
-            }
-            else if (!strcmp(key, "switchGun2X"))
-            {
-                sfk->switchGun2X = atof(value);
-            }
-            else if (!strcmp(key, "switchGun2Y"))
-            {
-                sfk->switchGun2Y = atof(value);
-            }
-            else if (!strcmp(key, "fragX"))
-            {
-                sfk->fragX = atof(value);
-            }
-            else if (!strcmp(key, "fragY"))
-            {
-                sfk->fragY = atof(value);
-            }
-            else if (!strcmp(key, "medicineX"))
-            {
-                sfk->medicineX = atof(value);
-            }
-            else if (!strcmp(key, "medicineY"))
-            {
-                sfk->medicineY = atof(value);
-            }
-            else if (!strcmp(key, "getOffCarX"))
-            {
-                sfk->getOffCarX = atof(value);
-            }
-            else if (!strcmp(key, "getOffCarY"))
-            {
-                sfk->getOffCarY = atof(value);
-            }
-            else if (!strcmp(key, "getOnCarX"))
-            {
-                sfk->getOnCarX = atof(value);
-            }
-            else if (!strcmp(key, "getOnCarY"))
-            {
-                sfk->getOnCarY = atof(value);
-            }
-            else if (!strcmp(key, "helpX"))
-            {
-                sfk->helpX = atof(value);
-            }
-            else if (!strcmp(key, "helpY"))
-            {
-                sfk->helpY = atof(value);
-            }
-            else if (!strcmp(key, "openDoorX"))
-            {
-                sfk->openDoorX = atof(value);
-            }
-            else if (!strcmp(key, "openDoorY"))
-            {
-                sfk->openDoorY = atof(value);
-            }
-            else if (!strcmp(key, "lickBagX"))
-            {
-                sfk->lickBagX = atof(value);
-            }
-            else if (!strcmp(key, "lickBagY"))
-            {
-                sfk->lickBagY = atof(value);
-            }
-            else if (!strcmp(key, "fireX"))
-            {
-                sfk->fireX = atof(value);
-            }
-            else if (!strcmp(key, "fireY"))
-            {
-                sfk->fireY = atof(value);
-            }
-            else if (!strcmp(key, "openMirrorX"))
-            {
-                sfk->openMirrorX = atof(value);
-            }
-            else if (!strcmp(key, "openMirrorY"))
-            {
-                sfk->openMirrorY = atof(value);
-            }
-            else if (!strcmp(key, "punctuationX"))
-            {
-                sfk->punctuationX = atof(value);
-            }
-            else if (!strcmp(key, "punctuationY"))
-            {
-                sfk->punctuationY = atof(value);
-            }
-        }
-    }
-
-    fclose(file);
-    return 0;
-}
-
-static void
-init_fpsgame_keys(struct sc_fpsgame_keys *sfk)
-{
-    sfk->pointX = 0.55; // 初始视角点
-    sfk->pointY = 0.4;
-    sfk->speedRatioX = 0.00025; // 鼠标速度
-    sfk->speedRatioY = 0.0006;
-    sfk->wheelCenterposX = 0.20;  // 方向轮盘中心点
-    sfk->wheelCenterposY = 0.75;
-    sfk->wheelLeftOffset = 0.1;  // 上下左右滑动的距离
-    sfk->wheelRightOffset = 0.1;
-    sfk->wheelUpOffset = 0.24;
-    sfk->wheeldownOffset = 0.2;
-    sfk->leftProbeX = 0.145; // 左右探头
-    sfk->leftProbeY = 0.364;
-    sfk->rightProbeX = 0.21;
-    sfk->rightProbeY = 0.364;
-    sfk->autoRunX = 0.84; // 自动跑
-    sfk->autoRunY = 0.26;
-    sfk->jumpX = 0.94; // 跳
-    sfk->jumpY = 0.7;
-    sfk->mapX = 0.95; // 地图
-    sfk->mapY = 0.03;
-    sfk->knapsackX = 0.09; // 背包
-    sfk->knapsackY = 0.9;
-    sfk->dropX = 0.91; // 趴
-    sfk->dropY = 0.9;
-    sfk->squatX = 0.84; // 蹲
-    sfk->squatY = 0.93;
-    sfk->reloadX = 0.76; // 装弹
-    sfk->reloadY = 0.93;
-    sfk->pickup1X = 0.7; // 拾取1
-    sfk->pickup1Y = 0.34;
-    sfk->pickup2X = 0.7; // 拾取2
-    sfk->pickup2Y = 0.44;
-    sfk->pickup3X = 0.7; // 拾取3
-    sfk->pickup3Y = 0.54;
-    sfk->switchGun1X = 0.45; // 换枪1
-    sfk->switchGun1Y = 0.9;
-    sfk->switchGun2X = 0.55; // 换枪2
-    sfk->switchGun2Y = 0.9;
-    sfk->fragX = 0.65; // 手雷
-    sfk->fragY = 0.92;
-    sfk->medicineX = 0.35; // 打药
-    sfk->medicineY = 0.95;
-    sfk->getOffCarX = 0.92; //  下车
-    sfk->getOffCarY = 0.4;
-    sfk->getOnCarX = 0.7; //  上车
-    sfk->getOnCarY = 0.54;
-    sfk->helpX = 0.49; //  救人
-    sfk->helpY = 0.63;
-    sfk->openDoorX = 0.7; //  开门
-    sfk->openDoorY = 0.7;
-    sfk->lickBagX = 0.7; //  舔包
-    sfk->lickBagY = 0.25;
-    sfk->fireX = 0.86; //  开火
-    sfk->fireY = 0.72;
-    sfk->openMirrorX = 0.94; //  开镜
-    sfk->openMirrorY = 0.52;
-    sfk->punctuationX = 0.888; //  万能标点
-    sfk->punctuationY = 0.338;
-
-    load_fpsgame_config(sfk);
-}
-
 enum scrcpy_exit_code
 scrcpy(struct scrcpy_options *options)
 {
@@ -755,6 +432,9 @@ scrcpy(struct scrcpy_options *options)
         .power_on = options->power_on,
         .kill_adb_on_close = options->kill_adb_on_close,
         .camera_high_speed = options->camera_high_speed,
+        .tcp_nodelay = options->tcp_nodelay,
+        .tune_video_socket = options->tune_video_socket,
+        .socket_send_buffer = options->socket_send_buffer,
         .list = options->list,
     };
 
@@ -768,12 +448,18 @@ scrcpy(struct scrcpy_options *options)
         return SCRCPY_EXIT_FAILURE;
     }
 
-    if (!sc_server_start(&s->server))
+    // A replayed stream does not need any device
+    bool replay = options->replay_stream;
+
+    if (!replay)
     {
-        goto end;
-    }
+        if (!sc_server_start(&s->server))
+        {
+            goto end;
+        }
 
-    server_started = true;
+        server_started = true;
+    }
 
     if (options->list)
     {
@@ -824,29 +510,34 @@ scrcpy(struct scrcpy_options *options)
 
     sdl_configure(options->video_playback, options->disable_screensaver);
 
-    // Await for server without blocking Ctrl+C handling
-    bool connected;
-    if (!await_for_server(&connected))
+    if (!replay)
     {
-        LOGE("Server connection failed");
-        goto end;
-    }
+        // Await for server without blocking Ctrl+C handling
+        bool connected;
+        if (!await_for_server(&connected))
+        {
+            LOGE("Server connection failed");
+            goto end;
+        }
 
-    if (!connected)
-    {
-        // This is not an error, user requested to quit
-        LOGD("User requested to quit");
-        ret = SCRCPY_EXIT_SUCCESS;
-        goto end;
-    }
+        if (!connected)
+        {
+            // This is not an error, user requested to quit
+            LOGD("User requested to quit");
+            ret = SCRCPY_EXIT_SUCCESS;
+            goto end;
+        }
 
-    LOGD("Server connected");
+        LOGD("Server connected");
+    }
 
-    // It is necessarily initialized here, since the device is connected
+    // It is necessarily initialized here, since the device is connected (it
+    // is not used on replay)
     struct sc_server_info *info = &s->server.info;
 
+    // Only used if control is enabled, so never on replay
     const char *serial = s->server.serial;
-    assert(serial);
+    assert(replay || serial);
 
     struct sc_file_pusher *fp = NULL;
 
@@ -867,7 +558,21 @@ scrcpy(struct scrcpy_options *options)
             .on_ended = sc_video_demuxer_on_ended,
         };
         sc_demuxer_init(&s->video_demuxer, "video", s->server.video_socket,
-                        &video_demuxer_cbs, NULL);
+                        options->video_decoder_threads, &video_demuxer_cbs,
+                        NULL);
+        if (replay)
+        {
+            sc_demuxer_set_replay(&s->video_demuxer, options->replay_stream,
+                                  !options->replay_fast);
+        }
+        if (options->dump_stream)
+        {
+            sc_demuxer_set_dump(&s->video_demuxer, options->dump_stream);
+        }
+        if (!replay && options->tcp_nodelay && options->tune_video_socket)
+        {
+            sc_demuxer_set_quickack(&s->video_demuxer);
+        }
     }
 
     if (options->audio)
@@ -876,7 +581,16 @@ scrcpy(struct scrcpy_options *options)
             .on_ended = sc_audio_demuxer_on_ended,
         };
         sc_demuxer_init(&s->audio_demuxer, "audio", s->server.audio_socket,
-                        &audio_demuxer_cbs, options);
+                        0, &audio_demuxer_cbs, options);
+        if (replay)
+        {
+            sc_demuxer_set_replay(&s->audio_demuxer, options->replay_stream,
+                                  !options->replay_fast);
+        }
+        if (options->dump_stream)
+        {
+            sc_demuxer_set_dump(&s->audio_demuxer, options->dump_stream);
+        }
     }
 
     bool needs_video_decoder = options->video_playback;
@@ -1081,12 +795,16 @@ scrcpy(struct scrcpy_options *options)
         }
 
         if (!sc_controller_init(&s->controller, s->server.control_socket,
-                                acksync))
+                                acksync, options->print_input_latency))
         {
             goto end;
         }
         controller_initialized = true;
 
+        // TCP_QUICKACK is not permanent, it must be re-armed after each
+        // receive
+        sc_controller_set_quickack(&s->controller, options->tcp_nodelay);
+
         if (!sc_controller_start(&s->controller))
         {
             goto end;
@@ -1100,11 +818,15 @@ scrcpy(struct scrcpy_options *options)
 
     if (options->video_playback)
     {
-        const char *window_title =
-            options->window_title ? options->window_title : info->device_name;
+        const char *window_title = options->window_title;
+        if (!window_title)
+        {
+            window_title = replay ? options->replay_stream : info->device_name;
+        }
 
         struct sc_fpsgame_keys *fpsgame_keys = &(s->fpsgame_keys);
-        init_fpsgame_keys(fpsgame_keys);
+        sc_fpsgame_keys_init(fpsgame_keys);
+        sc_fpsgame_keys_load(fpsgame_keys, SC_FPSGAME_CONFIG_FILENAME);
 
         struct sc_screen_params screen_params = {
             .controller = controller,
@@ -1124,16 +846,21 @@ scrcpy(struct scrcpy_options *options)
             .window_borderless = options->window_borderless,
             .orientation = options->display_orientation,
             .mipmaps = options->mipmaps,
+            .pbo = options->pbo,
             .fullscreen = options->fullscreen,
             .start_fps_counter = options->start_fps_counter,
+            .frame_policy = options->frame_policy,
+            .frame_ring_size = options->frame_ring_size,
+            .render_roi = options->render_roi,
             .fpsgame_keys = fpsgame_keys,
         };
 
         struct sc_frame_source *src = &s->video_decoder.frame_source;
         if (options->display_buffer)
         {
-            sc_delay_buffer_init(&s->display_buffer, options->display_buffer,
-                                 true);
+            sc_delay_buffer_init(&s->display_buffer, "display",
+                                 options->display_buffer,
+                                 options->display_buffer_max, true);
             sc_frame_source_add_sink(src, &s->display_buffer.frame_sink);
             src = &s->display_buffer.frame_source;
         }
@@ -1144,13 +871,22 @@ scrcpy(struct scrcpy_options *options)
         }
         screen_initialized = true;
 
+        if (options->display_buffer)
+        {
+            // Report the buffering statistics along with the FPS
+            sc_fps_counter_set_reporter(&s->screen.fps_counter,
+                                        sc_delay_buffer_request_report,
+                                        &s->display_buffer);
+        }
+
         sc_frame_source_add_sink(src, &s->screen.frame_sink);
     }
 
     if (options->audio_playback)
     {
         sc_audio_player_init(&s->audio_player, options->audio_buffer,
-                             options->audio_output_buffer);
+                             options->audio_output_buffer,
+                             options->audio_low_latency);
         sc_frame_source_add_sink(&s->audio_decoder.frame_source,
                                  &s->audio_player.frame_sink);
     }
@@ -1166,7 +902,15 @@ scrcpy(struct scrcpy_options *options)
         struct sc_frame_source *src = &s->video_decoder.frame_source;
         if (options->v4l2_buffer)
         {
-            sc_delay_buffer_init(&s->v4l2_buffer, options->v4l2_buffer, true);
+            sc_delay_buffer_init(&s->v4l2_buffer, "v4l2",
+                                 options->v4l2_buffer,
+                                 options->v4l2_buffer_max, true);
+            if (options->start_fps_counter)
+            {
+                // There is no FPS counter to request the reports
+                sc_delay_buffer_set_report_interval(&s->v4l2_buffer,
+                                                    SC_TICK_FROM_SEC(1));
+            }
             sc_frame_source_add_sink(src, &s->v4l2_buffer.frame_sink);
             src = &s->v4l2_buffer.frame_source;
         }
@@ -1293,6 +1037,16 @@ end:
         sc_server_stop(&s->server);
     }
 
+    // A replay is not interrupted by the sockets shutdown
+    if (video_demuxer_started)
+    {
+        sc_demuxer_interrupt(&s->video_demuxer);
+    }
+    if (audio_demuxer_started)
+    {
+        sc_demuxer_interrupt(&s->audio_demuxer);
+    }
+
     if (timeout_started)
     {
         sc_timeout_join(&s->timeout);
@@ -335,8 +335,8 @@ sc_screen_frame_sink_push(struct sc_frame_sink *sink, const AVFrame *frame) {
 
     if (previous_skipped) {
         sc_fps_counter_add_skipped_frame(&screen->fps_counter);
-        // The SC_EVENT_NEW_FRAME triggered for the previous frame will consume
-        // this new frame instead
+        // The SC_EVENT_NEW_FRAME triggered for the dropped frame will consume
+        // the next pending frame instead
     } else {
         static SDL_Event new_frame_event = {
             .type = SC_EVENT_NEW_FRAME,
@@ -353,6 +353,15 @@ sc_screen_frame_sink_push(struct sc_frame_sink *sink, const AVFrame *frame) {
     return true;
 }
 
+static bool
+sc_screen_frame_sink_is_late(struct sc_frame_sink *sink) {
+    struct sc_screen *screen = DOWNCAST(sink);
+
+    // The previous frame has not been rendered yet
+    return screen->frame_policy == SC_FRAME_POLICY_DECODE_DROP
+        && sc_frame_buffer_has_pending(&screen->fb);
+}
+
 bool
 sc_screen_init(struct sc_screen *screen,
                const struct sc_screen_params *params) {
@@ -370,7 +379,14 @@ sc_screen_init(struct sc_screen *screen,
     screen->req.fullscreen = params->fullscreen;
     screen->req.start_fps_counter = params->start_fps_counter;
 
-    bool ok = sc_frame_buffer_init(&screen->fb);
+    screen->roi_request = params->render_roi;
+    screen->roi_enabled = params->render_roi.width != 0;
+
+    screen->frame_policy = params->frame_policy;
+    unsigned capacity = params->frame_policy == SC_FRAME_POLICY_RING
+                      ? params->frame_ring_size : 1;
+
+    bool ok = sc_frame_buffer_init(&screen->fb, capacity);
     if (!ok) {
         return false;
     }
@@ -403,7 +419,8 @@ sc_screen_init(struct sc_screen *screen,
         goto error_destroy_fps_counter;
     }
 
-    ok = sc_display_init(&screen->display, screen->window, params->mipmaps);
+    ok = sc_display_init(&screen->display, screen->window, params->mipmaps,
+                         params->pbo);
     if (!ok) {
         goto error_destroy_window;
     }
@@ -422,6 +439,12 @@ sc_screen_init(struct sc_screen *screen,
         goto error_destroy_display;
     }
 
+    screen->roi_frame = av_frame_alloc();
+    if (!screen->roi_frame) {
+        LOG_OOM();
+        goto error_free_frame;
+    }
+
     struct sc_input_manager_params im_params = {
         .controller = params->controller,
         .fp = params->fp,
@@ -435,7 +458,16 @@ sc_screen_init(struct sc_screen *screen,
         .fpsgame_keys = params->fpsgame_keys,
     };
 
-    sc_input_manager_init(&screen->im, &im_params);
+    ok = sc_input_manager_init(&screen->im, &im_params);
+    if (!ok) {
+        goto error_free_roi_frame;
+    }
+
+    ok = sc_input_manager_start(&screen->im);
+    if (!ok) {
+        sc_input_manager_destroy(&screen->im);
+        goto error_free_roi_frame;
+    }
 
 #ifdef CONTINUOUS_RESIZING_WORKAROUND
     SDL_AddEventWatch(event_watcher, screen);
@@ -445,6 +477,7 @@ sc_screen_init(struct sc_screen *screen,
         .open = sc_screen_frame_sink_open,
         .close = sc_screen_frame_sink_close,
         .push = sc_screen_frame_sink_push,
+        .is_late = sc_screen_frame_sink_is_late,
     };
 
     screen->frame_sink.ops = &ops;
@@ -455,6 +488,10 @@ sc_screen_init(struct sc_screen *screen,
 
     return true;
 
+error_free_roi_frame:
+    av_frame_free(&screen->roi_frame);
+error_free_frame:
+    av_frame_free(&screen->frame);
 error_destroy_display:
     sc_display_destroy(&screen->display);
 error_destroy_window:
@@ -500,11 +537,13 @@ sc_screen_hide_window(struct sc_screen *screen) {
 
 void
 sc_screen_interrupt(struct sc_screen *screen) {
+    sc_input_manager_stop(&screen->im);
     sc_fps_counter_interrupt(&screen->fps_counter);
 }
 
 void
 sc_screen_join(struct sc_screen *screen) {
+    sc_input_manager_join(&screen->im);
     sc_fps_counter_join(&screen->fps_counter);
 }
 
@@ -513,7 +552,9 @@ sc_screen_destroy(struct sc_screen *screen) {
 #ifndef NDEBUG
     assert(!screen->open);
 #endif
+    sc_input_manager_destroy(&screen->im);
     sc_display_destroy(&screen->display);
+    av_frame_free(&screen->roi_frame);
     av_frame_free(&screen->frame);
     SDL_DestroyWindow(screen->window);
     sc_fps_counter_destroy(&screen->fps_counter);
@@ -560,6 +601,46 @@ apply_pending_resize(struct sc_screen *screen) {
     }
 }
 
+// compute the rendered region of the frame (screen->roi)
+static void
+sc_screen_update_roi(struct sc_screen *screen) {
+    struct sc_size frame_size = screen->frame_size;
+    SDL_Rect *roi = &screen->roi;
+
+    if (!screen->roi_enabled) {
+        roi->x = 0;
+        roi->y = 0;
+        roi->w = frame_size.width;
+        roi->h = frame_size.height;
+        return;
+    }
+
+    const struct sc_roi *req = &screen->roi_request;
+
+    // The chroma planes are subsampled, so keep the region aligned on 2
+    // pixels to crop the planes without conversion
+    int w = MIN(req->width, frame_size.width) & ~1;
+    int h = MIN(req->height, frame_size.height) & ~1;
+    if (!w || !h) {
+        // The frame is smaller than 2 pixels
+        w = frame_size.width;
+        h = frame_size.height;
+    }
+
+    int x = req->x < 0 ? (frame_size.width - w) / 2 : req->x;
+    int y = req->y < 0 ? (frame_size.height - h) / 2 : req->y;
+    roi->x = CLAMP(x, 0, frame_size.width - w) & ~1;
+    roi->y = CLAMP(y, 0, frame_size.height - h) & ~1;
+    roi->w = w;
+    roi->h = h;
+}
+
+static inline struct sc_size
+sc_screen_get_roi_size(struct sc_screen *screen) {
+    struct sc_size size = {screen->roi.w, screen->roi.h};
+    return size;
+}
+
 void
 sc_screen_set_orientation(struct sc_screen *screen,
                           enum sc_orientation orientation) {
@@ -568,7 +649,7 @@ sc_screen_set_orientation(struct sc_screen *screen,
     }
 
     struct sc_size new_content_size =
-        get_oriented_size(screen->frame_size, orientation);
+        get_oriented_size(sc_screen_get_roi_size(screen), orientation);
 
     set_content_size(screen, new_content_size);
 
@@ -585,12 +666,15 @@ sc_screen_init_size(struct sc_screen *screen) {
 
     // The requested size is passed via screen->frame_size
 
+    sc_screen_update_roi(screen);
+    struct sc_size roi_size = sc_screen_get_roi_size(screen);
+
     struct sc_size content_size =
-        get_oriented_size(screen->frame_size, screen->orientation);
+        get_oriented_size(roi_size, screen->orientation);
     screen->content_size = content_size;
 
     enum sc_display_result res =
-        sc_display_set_texture_size(&screen->display, screen->frame_size);
+        sc_display_set_texture_size(&screen->display, roi_size);
     return res != SC_DISPLAY_RESULT_ERROR;
 }
 
@@ -605,13 +689,53 @@ prepare_for_frame(struct sc_screen *screen, struct sc_size new_frame_size) {
     // frame dimension changed
     screen->frame_size = new_frame_size;
 
+    sc_screen_update_roi(screen);
+    struct sc_size roi_size = sc_screen_get_roi_size(screen);
+
     struct sc_size new_content_size =
-        get_oriented_size(new_frame_size, screen->orientation);
+        get_oriented_size(roi_size, screen->orientation);
     set_content_size(screen, new_content_size);
 
     sc_screen_update_content_rect(screen);
 
-    return sc_display_set_texture_size(&screen->display, screen->frame_size);
+    return sc_display_set_texture_size(&screen->display, roi_size);
+}
+
+// upload the region of interest of the frame to the texture
+static enum sc_display_result
+sc_screen_update_texture(struct sc_screen *screen, const AVFrame *frame) {
+    const SDL_Rect *roi = &screen->roi;
+    if (roi->w == frame->width && roi->h == frame->height) {
+        // Whole frame
+        return sc_display_update_texture(&screen->display, frame);
+    }
+
+    // Crop a reference to the frame, without copying: only the data pointers
+    // of the planes are moved
+    AVFrame *cropped = screen->roi_frame;
+    int r = av_frame_ref(cropped, frame);
+    if (r) {
+        LOGE("Could not ref frame: %d", r);
+        return SC_DISPLAY_RESULT_ERROR;
+    }
+
+    cropped->crop_left = roi->x;
+    cropped->crop_top = roi->y;
+    cropped->crop_right = frame->width - roi->x - roi->w;
+    cropped->crop_bottom = frame->height - roi->y - roi->h;
+
+    // The region is aligned on the chroma subsampling
+    r = av_frame_apply_cropping(cropped, AV_FRAME_CROP_UNALIGNED);
+    if (r) {
+        LOGE("Could not crop frame: %d", r);
+        av_frame_unref(cropped);
+        return SC_DISPLAY_RESULT_ERROR;
+    }
+
+    enum sc_display_result res =
+        sc_display_update_texture(&screen->display, cropped);
+    av_frame_unref(cropped);
+    return res;
 }
 
 static bool
@@ -632,7 +756,7 @@ sc_screen_update_frame(struct sc_screen *screen) {
         return true;
     }
 
-    res = sc_display_update_texture(&screen->display, frame);
+    res = sc_screen_update_texture(screen, frame);
     if (res == SC_DISPLAY_RESULT_ERROR) {
         return false;
     }
@@ -673,6 +797,45 @@ sc_screen_switch_fullscreen(struct sc_screen *screen) {
     sc_screen_render(screen, true);
 }
 
+void
+sc_screen_switch_roi(struct sc_screen *screen) {
+    if (!screen->roi_request.width) {
+        LOGI("No region of interest (see --render-roi)");
+        return;
+    }
+
+    if (!screen->has_frame) {
+        return;
+    }
+
+    screen->roi_enabled = !screen->roi_enabled;
+    LOGI("Rendering %s", screen->roi_enabled ? "the region of interest"
+                                             : "the whole frame");
+
+    sc_screen_update_roi(screen);
+    struct sc_size roi_size = sc_screen_get_roi_size(screen);
+
+    set_content_size(screen,
+                     get_oriented_size(roi_size, screen->orientation));
+    sc_screen_update_content_rect(screen);
+
+    enum sc_display_result res =
+        sc_display_set_texture_size(&screen->display, roi_size);
+    if (res != SC_DISPLAY_RESULT_OK) {
+        // The next frame will be uploaded once the texture is created
+        return;
+    }
+
+    // Upload the last frame again, the device screen may not change
+    res = sc_screen_update_texture(screen, screen->frame);
+    if (res == SC_DISPLAY_RESULT_ERROR) {
+        LOGW("Could not update the texture");
+        return;
+    }
+
+    sc_screen_render(screen, true);
+}
+
 void
 sc_screen_resize_to_fit(struct sc_screen *screen) {
     if (screen->fullscreen || screen->maximized || screen->minimized) {
@@ -806,12 +969,10 @@ sc_screen_handle_event(struct sc_screen *screen, const SDL_Event *event) {
                     if (key == cap) {
                         // 切换鼠标
                         sc_screen_toggle_mouse_capture(screen);
-                        struct sc_fpsgame_keys *sfk = screen->im.fpsgame_keys;
                         if (mouse_capture) {
-                            sc_input_manager_send_touch_event(&screen->im, sfk->pointX, sfk->pointY, SDL_FINGERUP, 2);
+                            sc_input_manager_aim_stop(&screen->im);
                         } else {
-                            sfk->pointX = 0.55, sfk->pointY = 0.4;
-                            sc_input_manager_send_touch_event(&screen->im, sfk->pointX, sfk->pointY, SDL_FINGERDOWN, 2);
+                            sc_input_manager_aim_start(&screen->im);
                         }
                     }
                     return true;
@@ -903,6 +1064,10 @@ sc_screen_convert_drawable_to_frame_coords(struct sc_screen *screen,
             break;
     }
 
+    // The content is the region of interest of the frame
+    result.x += screen->roi.x;
+    result.y += screen->roi.y;
+
     return result;
 }
 
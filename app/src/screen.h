@@ -30,6 +30,7 @@ struct sc_screen {
     struct sc_input_manager im;
     struct sc_frame_buffer fb;
     struct sc_fps_counter fps_counter;
+    enum sc_frame_policy frame_policy;
 
     // The initial requested window properties
     struct {
@@ -43,7 +44,13 @@ struct sc_screen {
 
     SDL_Window *window;
     struct sc_size frame_size;
-    struct sc_size content_size; // rotated frame_size
+    struct sc_size content_size; // rotated roi size
+
+    // Region of interest: if enabled, only this part of the frame is uploaded
+    // and rendered
+    struct sc_roi roi_request;
+    bool roi_enabled;
+    SDL_Rect roi; // in frame coordinates, the whole frame if disabled
 
     bool resize_pending; // resize requested while fullscreen or maximized
     // The content size the last time the window was not maximized or
@@ -63,6 +70,7 @@ struct sc_screen {
     SDL_Keycode mouse_capture_key_pressed;
 
     AVFrame *frame;
+    AVFrame *roi_frame; // cropped reference to frame
 };
 
 struct sc_screen_params {
@@ -89,9 +97,15 @@ struct sc_screen_params {
 
     enum sc_orientation orientation;
     bool mipmaps;
+    bool pbo;
 
     bool fullscreen;
     bool start_fps_counter;
+
+    enum sc_frame_policy frame_policy;
+    uint8_t frame_ring_size; // for SC_FRAME_POLICY_RING
+
+    struct sc_roi render_roi;
 };
 
 // initialize screen, create window, renderer and texture (window is hidden)
@@ -122,6 +136,10 @@ sc_screen_hide_window(struct sc_screen *screen);
 void
 sc_screen_switch_fullscreen(struct sc_screen *screen);
 
+// switch between the region of interest and the whole frame
+void
+sc_screen_switch_roi(struct sc_screen *screen);
+
 // resize window to optimal size (remove black borders)
 void
 sc_screen_resize_to_fit(struct sc_screen *screen);
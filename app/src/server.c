@@ -607,6 +607,28 @@ sc_server_connect_to(struct sc_server *server, struct sc_server_info *info) {
         }
     }
 
+    if (control || server->params.tune_video_socket) {
+        struct sc_socket_tuning tuning = {
+            .nodelay = server->params.tcp_nodelay,
+            .quickack = server->params.tcp_nodelay,
+            .send_buffer = server->params.socket_send_buffer,
+        };
+
+        // Control messages are small and must not be delayed by Nagle's
+        // algorithm
+        if (control && !net_set_tuning(control_socket, &tuning)) {
+            LOGW("Could not tune control socket");
+        }
+
+        if (video && server->params.tune_video_socket) {
+            // The video socket only sends acks from this side
+            tuning.send_buffer = 0;
+            if (!net_set_tuning(video_socket, &tuning)) {
+                LOGW("Could not tune video socket");
+            }
+        }
+    }
+
     // we don't need the adb tunnel anymore
     sc_adb_tunnel_close(tunnel, &server->intr, serial,
                         server->device_socket_name);
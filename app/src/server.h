@@ -64,6 +64,9 @@ struct sc_server_params {
     bool power_on;
     bool kill_adb_on_close;
     bool camera_high_speed;
+    bool tcp_nodelay;
+    bool tune_video_socket;
+    uint32_t socket_send_buffer;
     uint8_t list;
 };
 
@@ -21,6 +21,15 @@ struct sc_frame_sink_ops {
     bool (*open)(struct sc_frame_sink *sink, const AVCodecContext *ctx);
     void (*close)(struct sc_frame_sink *sink);
     bool (*push)(struct sc_frame_sink *sink, const AVFrame *frame);
+
+    /**
+     * Optional: return true if the sink has not consumed the previous frames
+     * yet, and would drop a new frame anyway.
+     *
+     * It is useful to let the decoder skip the decoding of non-reference
+     * frames when the screen is behind.
+     */
+    bool (*is_late)(struct sc_frame_sink *sink);
 };
 
 #endif
@@ -57,3 +57,16 @@ sc_frame_source_sinks_push(struct sc_frame_source *source,
 
     return true;
 }
+
+bool
+sc_frame_source_sinks_are_late(struct sc_frame_source *source) {
+    assert(source->sink_count);
+    for (unsigned i = 0; i < source->sink_count; ++i) {
+        struct sc_frame_sink *sink = source->sinks[i];
+        if (!sink->ops->is_late || !sink->ops->is_late(sink)) {
+            return false;
+        }
+    }
+
+    return true;
+}
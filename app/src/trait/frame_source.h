@@ -35,4 +35,11 @@ bool
 sc_frame_source_sinks_push(struct sc_frame_source *source,
                            const AVFrame *frame);
 
+/**
+ * Return true if all the sinks are late (a sink not implementing is_late() is
+ * never late)
+ */
+bool
+sc_frame_source_sinks_are_late(struct sc_frame_source *source);
+
 #endif
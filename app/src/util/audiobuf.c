@@ -0,0 +1,160 @@
+#include "audiobuf.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/log.h"
+
+bool
+sc_audiobuf_init(struct sc_audiobuf *buf, size_t sample_size,
+                 uint32_t capacity) {
+    assert(sample_size);
+    assert(capacity);
+
+    // The actual capacity is (alloc_size - 1) so that head == tail is
+    // non-ambiguous
+    buf->alloc_size = capacity + 1;
+    buf->data = malloc(buf->alloc_size * sample_size);
+    if (!buf->data) {
+        LOG_OOM();
+        return false;
+    }
+
+    buf->sample_size = sample_size;
+    atomic_init(&buf->head, 0);
+    atomic_init(&buf->tail, 0);
+
+    return true;
+}
+
+void
+sc_audiobuf_destroy(struct sc_audiobuf *buf) {
+    free(buf->data);
+}
+
+uint32_t
+sc_audiobuf_read(struct sc_audiobuf *buf, void *to_, uint32_t samples_count) {
+    uint8_t *to = to_;
+
+    // Only the consumer writes the tail
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_relaxed);
+    // Synchronize with the release store of the producer, so that the samples
+    // written before the head was updated are visible
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_acquire);
+
+    uint32_t can_read = (buf->alloc_size + head - tail) % buf->alloc_size;
+    if (samples_count > can_read) {
+        samples_count = can_read;
+    }
+    if (!samples_count) {
+        return 0;
+    }
+
+    uint32_t right_count = buf->alloc_size - tail;
+    if (right_count > samples_count) {
+        right_count = samples_count;
+    }
+    memcpy(to, buf->data + tail * buf->sample_size,
+           right_count * buf->sample_size);
+
+    if (samples_count > right_count) {
+        uint32_t left_count = samples_count - right_count;
+        memcpy(to + right_count * buf->sample_size, buf->data,
+               left_count * buf->sample_size);
+    }
+
+    tail = (tail + samples_count) % buf->alloc_size;
+    // Publish the space released, only after the samples have been copied
+    atomic_store_explicit(&buf->tail, tail, memory_order_release);
+
+    return samples_count;
+}
+
+uint32_t
+sc_audiobuf_skip(struct sc_audiobuf *buf, uint32_t samples_count) {
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_acquire);
+
+    uint32_t can_read = (buf->alloc_size + head - tail) % buf->alloc_size;
+    if (samples_count > can_read) {
+        samples_count = can_read;
+    }
+    if (!samples_count) {
+        return 0;
+    }
+
+    tail = (tail + samples_count) % buf->alloc_size;
+    atomic_store_explicit(&buf->tail, tail, memory_order_release);
+
+    return samples_count;
+}
+
+uint32_t
+sc_audiobuf_make_room(struct sc_audiobuf *buf, uint32_t samples_count) {
+    uint32_t can_write = sc_audiobuf_can_write(buf);
+    if (samples_count <= can_write) {
+        return 0;
+    }
+
+    return sc_audiobuf_skip(buf, samples_count - can_write);
+}
+
+uint32_t
+sc_audiobuf_write(struct sc_audiobuf *buf, const void *from_,
+                  uint32_t samples_count) {
+    const uint8_t *from = from_;
+
+    // Only the producer writes the head
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+    // Synchronize with the release store of the consumer, so that the samples
+    // are not overwritten before they have been read
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+
+    uint32_t can_write = (buf->alloc_size + tail - head - 1) % buf->alloc_size;
+    if (samples_count > can_write) {
+        samples_count = can_write;
+    }
+    if (!samples_count) {
+        return 0;
+    }
+
+    uint32_t right_count = buf->alloc_size - head;
+    if (right_count > samples_count) {
+        right_count = samples_count;
+    }
+    memcpy(buf->data + head * buf->sample_size, from,
+           right_count * buf->sample_size);
+
+    if (samples_count > right_count) {
+        uint32_t left_count = samples_count - right_count;
+        memcpy(buf->data, from + right_count * buf->sample_size,
+               left_count * buf->sample_size);
+    }
+
+    head = (head + samples_count) % buf->alloc_size;
+    // Publish the samples, only after they have been copied
+    atomic_store_explicit(&buf->head, head, memory_order_release);
+
+    return samples_count;
+}
+
+uint32_t
+sc_audiobuf_write_area(struct sc_audiobuf *buf, void **area) {
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+
+    uint32_t can_write = (buf->alloc_size + tail - head - 1) % buf->alloc_size;
+    uint32_t right_count = buf->alloc_size - head;
+
+    *area = buf->data + head * buf->sample_size;
+    return MIN(can_write, right_count);
+}
+
+void
+sc_audiobuf_commit_write(struct sc_audiobuf *buf, uint32_t samples_count) {
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_relaxed);
+    assert(samples_count <= sc_audiobuf_can_write(buf));
+
+    head = (head + samples_count) % buf->alloc_size;
+    atomic_store_explicit(&buf->head, head, memory_order_release);
+}
@@ -3,19 +3,32 @@
 
 #include "common.h"
 
+#include <assert.h>
+#include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
-#include "util/bytebuf.h"
-
 /**
- * Wrapper around bytebuf to read and write samples
+ * Wait-free single-producer single-consumer ring buffer of samples
  *
  * Each sample takes sample_size bytes.
+ *
+ * One thread (the producer) may call write(), while another thread (the
+ * consumer) calls read() or skip(), without any lock: each cursor is only
+ * written by one side, and published with release semantics.
  */
 struct sc_audiobuf {
-    struct sc_bytebuf buf;
+    uint8_t *data;
+    // The actual capacity is (alloc_size - 1) so that head == tail is
+    // non-ambiguous
+    uint32_t alloc_size; // in samples
     size_t sample_size;
+
+    atomic_uint_least32_t head; // writer cursor, in samples
+    atomic_uint_least32_t tail; // reader cursor, in samples
+    // empty: tail == head
+    // full: ((tail + 1) % alloc_size) == head
 };
 
 static inline uint32_t
@@ -29,66 +42,103 @@ sc_audiobuf_to_bytes(struct sc_audiobuf *buf, uint32_t samples) {
     return samples * buf->sample_size;
 }
 
-static inline bool
+bool
 sc_audiobuf_init(struct sc_audiobuf *buf, size_t sample_size,
-                 uint32_t capacity) {
-    buf->sample_size = sample_size;
-    return sc_bytebuf_init(&buf->buf, capacity * sample_size + 1);
-}
+                 uint32_t capacity);
 
-static inline void
-sc_audiobuf_read(struct sc_audiobuf *buf, uint8_t *to, uint32_t samples) {
-    size_t bytes = sc_audiobuf_to_bytes(buf, samples);
-    sc_bytebuf_read(&buf->buf, to, bytes);
-}
+void
+sc_audiobuf_destroy(struct sc_audiobuf *buf);
 
-static inline void
-sc_audiobuf_skip(struct sc_audiobuf *buf, uint32_t samples) {
-    size_t bytes = sc_audiobuf_to_bytes(buf, samples);
-    sc_bytebuf_skip(&buf->buf, bytes);
-}
+/**
+ * Read up to samples_count samples (consumer only)
+ *
+ * Return the number of samples actually read.
+ */
+uint32_t
+sc_audiobuf_read(struct sc_audiobuf *buf, void *to, uint32_t samples_count);
 
-static inline void
-sc_audiobuf_write(struct sc_audiobuf *buf, const uint8_t *from,
-                  uint32_t samples) {
-    size_t bytes = sc_audiobuf_to_bytes(buf, samples);
-    sc_bytebuf_write(&buf->buf, from, bytes);
-}
+/**
+ * Drop up to samples_count samples (consumer only)
+ *
+ * Return the number of samples actually dropped.
+ */
+uint32_t
+sc_audiobuf_skip(struct sc_audiobuf *buf, uint32_t samples_count);
 
-static inline void
-sc_audiobuf_prepare_write(struct sc_audiobuf *buf, const uint8_t *from,
-                          uint32_t samples) {
-    size_t bytes = sc_audiobuf_to_bytes(buf, samples);
-    sc_bytebuf_prepare_write(&buf->buf, from, bytes);
-}
+/**
+ * Drop the oldest samples so that samples_count samples can be written
+ *
+ * Like skip(), this moves the reader cursor: the producer may only call it
+ * while the consumer is not running (for example with the audio device
+ * locked).
+ *
+ * Return the number of samples actually dropped.
+ */
+uint32_t
+sc_audiobuf_make_room(struct sc_audiobuf *buf, uint32_t samples_count);
 
-static inline void
-sc_audiobuf_commit_write(struct sc_audiobuf *buf, uint32_t samples) {
-    size_t bytes = sc_audiobuf_to_bytes(buf, samples);
-    sc_bytebuf_commit_write(&buf->buf, bytes);
-}
+/**
+ * Write up to samples_count samples (producer only)
+ *
+ * Return the number of samples actually written (less than samples_count if
+ * the buffer is full).
+ */
+uint32_t
+sc_audiobuf_write(struct sc_audiobuf *buf, const void *from,
+                  uint32_t samples_count);
+
+/**
+ * Get the area where the next samples can be written in place (producer only)
+ *
+ * This allows to produce samples directly into the buffer, without an
+ * intermediate copy. The free space may be split in two parts (around the end
+ * of the buffer), so the caller must call this function again after
+ * sc_audiobuf_commit_write() to get the remaining part.
+ *
+ * Return the number of samples which can be written contiguously to *area.
+ */
+uint32_t
+sc_audiobuf_write_area(struct sc_audiobuf *buf, void **area);
+
+/**
+ * Publish samples written in place to the area returned by
+ * sc_audiobuf_write_area() (producer only)
+ */
+void
+sc_audiobuf_commit_write(struct sc_audiobuf *buf, uint32_t samples_count);
 
+/**
+ * Return the number of samples which can be read
+ *
+ * If called from the producer, the actual value may only be greater (the
+ * consumer may have read samples in the meantime), and conversely.
+ */
 static inline uint32_t
 sc_audiobuf_can_read(struct sc_audiobuf *buf) {
-    size_t bytes = sc_bytebuf_can_read(&buf->buf);
-    return sc_audiobuf_to_samples(buf, bytes);
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+    return (buf->alloc_size + head - tail) % buf->alloc_size;
 }
 
+/**
+ * Return the number of samples which can be written
+ *
+ * If called from the producer, the actual value may only be greater (the
+ * consumer may have read samples in the meantime).
+ */
 static inline uint32_t
 sc_audiobuf_can_write(struct sc_audiobuf *buf) {
-    size_t bytes = sc_bytebuf_can_write(&buf->buf);
-    return sc_audiobuf_to_samples(buf, bytes);
+    uint32_t head = atomic_load_explicit(&buf->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&buf->tail, memory_order_acquire);
+    return (buf->alloc_size + tail - head - 1) % buf->alloc_size;
 }
 
+/**
+ * Return the actual capacity of the buffer (can_read() + can_write())
+ */
 static inline uint32_t
 sc_audiobuf_capacity(struct sc_audiobuf *buf) {
-    size_t bytes = sc_bytebuf_capacity(&buf->buf);
-    return sc_audiobuf_to_samples(buf, bytes);
-}
-
-static inline void
-sc_audiobuf_destroy(struct sc_audiobuf *buf) {
-    sc_bytebuf_destroy(&buf->buf);
+    return buf->alloc_size - 1;
 }
 
 #endif
@@ -0,0 +1,93 @@
+#include "audioconv.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+# define SC_AUDIOCONV_SSE2
+#elif defined(__ARM_NEON)
+# include <arm_neon.h>
+# define SC_AUDIOCONV_NEON
+#endif
+
+// Same scale as libswresample for S16 to float
+#define SC_AUDIOCONV_S16_SCALE (1.0f / (1 << 15))
+
+static void
+sc_audioconv_interleave_f32_stereo(float *dst, const float *left,
+                                   const float *right, uint32_t samples) {
+    uint32_t i = 0;
+#if defined(SC_AUDIOCONV_SSE2)
+    for (; i + 4 <= samples; i += 4) {
+        __m128 l = _mm_loadu_ps(&left[i]);
+        __m128 r = _mm_loadu_ps(&right[i]);
+        _mm_storeu_ps(&dst[2 * i], _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(&dst[2 * i + 4], _mm_unpackhi_ps(l, r));
+    }
+#elif defined(SC_AUDIOCONV_NEON)
+    for (; i + 4 <= samples; i += 4) {
+        float32x4x2_t lr = {{vld1q_f32(&left[i]), vld1q_f32(&right[i])}};
+        vst2q_f32(&dst[2 * i], lr);
+    }
+#endif
+    for (; i < samples; ++i) {
+        dst[2 * i] = left[i];
+        dst[2 * i + 1] = right[i];
+    }
+}
+
+void
+sc_audioconv_interleave_f32(float *dst, const float *const *src,
+                            unsigned channels, uint32_t offset,
+                            uint32_t samples) {
+    if (channels == 1) {
+        memcpy(dst, &src[0][offset], samples * sizeof(float));
+        return;
+    }
+
+    if (channels == 2) {
+        sc_audioconv_interleave_f32_stereo(dst, &src[0][offset],
+                                           &src[1][offset], samples);
+        return;
+    }
+
+    for (uint32_t i = 0; i < samples; ++i) {
+        for (unsigned c = 0; c < channels; ++c) {
+            *dst++ = src[c][offset + i];
+        }
+    }
+}
+
+void
+sc_audioconv_s16_to_f32(float *dst, const int16_t *src, unsigned channels,
+                        uint32_t offset, uint32_t samples) {
+    // Interleaved, so the channels do not matter
+    src += offset * channels;
+    uint32_t count = samples * channels;
+
+    uint32_t i = 0;
+#if defined(SC_AUDIOCONV_SSE2)
+    __m128 scale = _mm_set1_ps(SC_AUDIOCONV_S16_SCALE);
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_loadu_si128((const __m128i *) &src[i]);
+        // Sign-extend to 32 bits by moving each value to the high half
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(&dst[i + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#elif defined(SC_AUDIOCONV_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t v = vld1q_s16(&src[i]);
+        int32x4_t lo = vmovl_s16(vget_low_s16(v));
+        int32x4_t hi = vmovl_s16(vget_high_s16(v));
+        vst1q_f32(&dst[i], vmulq_n_f32(vcvtq_f32_s32(lo),
+                                       SC_AUDIOCONV_S16_SCALE));
+        vst1q_f32(&dst[i + 4], vmulq_n_f32(vcvtq_f32_s32(hi),
+                                           SC_AUDIOCONV_S16_SCALE));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = src[i] * SC_AUDIOCONV_S16_SCALE;
+    }
+}
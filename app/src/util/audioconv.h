@@ -0,0 +1,32 @@
+#ifndef SC_AUDIOCONV_H
+#define SC_AUDIOCONV_H
+
+#include "common.h"
+
+#include <stdint.h>
+
+/**
+ * Sample format conversion kernels to interleaved float (AUDIO_F32)
+ *
+ * They are vectorized (SSE2 or NEON) when available. The samples are
+ * processed from index offset (in samples per channel) in the source, so that
+ * a single frame may be written in several parts (around the end of a ring
+ * buffer).
+ */
+
+/**
+ * Interleave planar float samples (AV_SAMPLE_FMT_FLTP)
+ */
+void
+sc_audioconv_interleave_f32(float *dst, const float *const *src,
+                            unsigned channels, uint32_t offset,
+                            uint32_t samples);
+
+/**
+ * Convert interleaved signed 16-bit samples (AV_SAMPLE_FMT_S16)
+ */
+void
+sc_audioconv_s16_to_f32(float *dst, const int16_t *src, unsigned channels,
+                        uint32_t offset, uint32_t samples);
+
+#endif
@@ -0,0 +1,71 @@
+#include "histogram.h"
+
+#include <assert.h>
+#include <string.h>
+
+void
+sc_histogram_reset(struct sc_histogram *h) {
+    memset(h, 0, sizeof(*h));
+}
+
+static unsigned
+get_bucket(sc_tick value) {
+    if (value < 4) {
+        return value < 0 ? 0 : value;
+    }
+
+    unsigned log2 = 2;
+    while (value >> (log2 + 1)) {
+        ++log2;
+    }
+
+    unsigned index = 4 * (log2 - 1) + ((value >> (log2 - 2)) & 3);
+    return index < SC_HISTOGRAM_BUCKETS ? index : SC_HISTOGRAM_BUCKETS - 1;
+}
+
+// Upper bound (inclusive) of the values stored in the bucket
+static sc_tick
+get_bucket_max(unsigned index) {
+    if (index < 4) {
+        return index;
+    }
+
+    unsigned log2 = index / 4 + 1;
+    unsigned sub = index % 4;
+    return ((sc_tick) (5 + sub) << (log2 - 2)) - 1;
+}
+
+void
+sc_histogram_add(struct sc_histogram *h, sc_tick value) {
+    ++h->buckets[get_bucket(value)];
+    ++h->count;
+    if (value > h->max) {
+        h->max = value;
+    }
+}
+
+sc_tick
+sc_histogram_percentile(const struct sc_histogram *h, unsigned percent) {
+    assert(percent <= 100);
+    if (!h->count) {
+        return 0;
+    }
+
+    // Rank of the requested value (1-based), rounded up
+    uint64_t rank = (h->count * percent + 99) / 100;
+    if (!rank) {
+        rank = 1;
+    }
+
+    uint64_t cumul = 0;
+    for (unsigned i = 0; i < SC_HISTOGRAM_BUCKETS; ++i) {
+        cumul += h->buckets[i];
+        if (cumul >= rank) {
+            sc_tick bound = get_bucket_max(i);
+            return bound < h->max ? bound : h->max;
+        }
+    }
+
+    assert(!"unreachable");
+    return h->max;
+}
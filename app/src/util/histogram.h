@@ -0,0 +1,38 @@
+#ifndef SC_HISTOGRAM_H
+#define SC_HISTOGRAM_H
+
+#include "common.h"
+
+#include <stdint.h>
+
+#include "util/tick.h"
+
+// Quarter-octave buckets: values below 4 are exact, then each power of two
+// is split into 4 buckets (relative precision 25%), up to 2^40 ticks
+#define SC_HISTOGRAM_BUCKETS 160
+
+/**
+ * Histogram of durations, with constant-time insertion
+ */
+struct sc_histogram {
+    uint64_t count;
+    sc_tick max;
+    uint32_t buckets[SC_HISTOGRAM_BUCKETS];
+};
+
+void
+sc_histogram_reset(struct sc_histogram *h);
+
+void
+sc_histogram_add(struct sc_histogram *h, sc_tick value);
+
+/**
+ * Return an upper bound of the given percentile (between 0 and 100)
+ *
+ * The result is the upper bound of the bucket containing the percentile,
+ * capped by the max value. Return 0 if the histogram is empty.
+ */
+sc_tick
+sc_histogram_percentile(const struct sc_histogram *h, unsigned percent);
+
+#endif
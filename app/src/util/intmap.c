@@ -11,3 +11,32 @@ sc_intmap_find_entry(const struct sc_intmap_entry entries[], size_t len,
     }
     return NULL;
 }
+
+const struct sc_intmap_entry *
+sc_intmap_find_entry_sorted(const struct sc_intmap_entry entries[], size_t len,
+                            int32_t key) {
+    size_t low = 0;
+    size_t high = len;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const struct sc_intmap_entry *entry = &entries[mid];
+        if (entry->key < key) {
+            low = mid + 1;
+        } else if (entry->key > key) {
+            high = mid;
+        } else {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+bool
+sc_intmap_is_sorted(const struct sc_intmap_entry entries[], size_t len) {
+    for (size_t i = 1; i < len; ++i) {
+        if (entries[i - 1].key >= entries[i].key) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -3,6 +3,7 @@
 
 #include "common.h"
 
+#include <stdbool.h>
 #include <stdint.h>
 
 struct sc_intmap_entry {
@@ -14,6 +15,18 @@ const struct sc_intmap_entry *
 sc_intmap_find_entry(const struct sc_intmap_entry entries[], size_t len,
                      int32_t key);
 
+/**
+ * Same as sc_intmap_find_entry(), using a binary search
+ *
+ * The entries must be sorted by strictly increasing key.
+ */
+const struct sc_intmap_entry *
+sc_intmap_find_entry_sorted(const struct sc_intmap_entry entries[], size_t len,
+                            int32_t key);
+
+bool
+sc_intmap_is_sorted(const struct sc_intmap_entry entries[], size_t len);
+
 /**
  * MAP is expected to be a static array of sc_intmap_entry, so that
  * ARRAY_LEN(MAP) can be computed statically.
@@ -21,4 +34,13 @@ sc_intmap_find_entry(const struct sc_intmap_entry entries[], size_t len,
 #define SC_INTMAP_FIND_ENTRY(MAP, KEY) \
     sc_intmap_find_entry(MAP, ARRAY_LEN(MAP), KEY)
 
+/**
+ * MAP is expected to be a static array of sc_intmap_entry sorted by key.
+ *
+ * The order is not checked on lookup (it would cost more than the binary
+ * search saves), it must be asserted once by a unit test.
+ */
+#define SC_INTMAP_FIND_ENTRY_SORTED(MAP, KEY) \
+    sc_intmap_find_entry_sorted(MAP, ARRAY_LEN(MAP), KEY)
+
 #endif
@@ -15,6 +15,7 @@
 # include <sys/types.h>
 # include <sys/socket.h>
 # include <netinet/in.h>
+# include <netinet/tcp.h>
 # include <arpa/inet.h>
 # include <unistd.h>
 # include <fcntl.h>
@@ -186,6 +187,36 @@ net_listen(sc_socket server_socket, uint32_t addr, uint16_t port, int backlog) {
     return true;
 }
 
+bool
+net_set_tuning(sc_socket socket, const struct sc_socket_tuning *tuning) {
+    sc_raw_socket raw_sock = unwrap(socket);
+    bool ok = true;
+
+    if (tuning->nodelay) {
+        int nodelay = 1;
+        if (setsockopt(raw_sock, IPPROTO_TCP, TCP_NODELAY,
+                       (const void *) &nodelay, sizeof(nodelay)) == -1) {
+            net_perror("setsockopt(TCP_NODELAY)");
+            ok = false;
+        }
+    }
+
+    if (tuning->quickack && !net_set_quickack(socket)) {
+        ok = false;
+    }
+
+    if (tuning->send_buffer) {
+        int size = tuning->send_buffer;
+        if (setsockopt(raw_sock, SOL_SOCKET, SO_SNDBUF, (const void *) &size,
+                       sizeof(size)) == -1) {
+            net_perror("setsockopt(SO_SNDBUF)");
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
 sc_socket
 net_accept(sc_socket server_socket) {
     sc_raw_socket raw_server_socket = unwrap(server_socket);
@@ -208,6 +239,22 @@ net_accept(sc_socket server_socket) {
     return wrap(raw_sock);
 }
 
+bool
+net_set_quickack(sc_socket socket) {
+#ifdef TCP_QUICKACK
+    sc_raw_socket raw_sock = unwrap(socket);
+    int quickack = 1;
+    if (setsockopt(raw_sock, IPPROTO_TCP, TCP_QUICKACK,
+                   (const void *) &quickack, sizeof(quickack)) == -1) {
+        net_perror("setsockopt(TCP_QUICKACK)");
+        return false;
+    }
+#else
+    (void) socket;
+#endif
+    return true;
+}
+
 ssize_t
 net_recv(sc_socket socket, void *buf, size_t len) {
     sc_raw_socket raw_sock = unwrap(socket);
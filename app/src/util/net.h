@@ -26,6 +26,16 @@
 
 #define IPV4_LOCALHOST 0x7F000001
 
+struct sc_socket_tuning {
+    // Disable Nagle's algorithm, so that small writes are sent immediately
+    bool nodelay;
+    // Acknowledge incoming segments immediately (Linux only, ignored
+    // elsewhere). This only arms it once, see net_set_quickack().
+    bool quickack;
+    // Size of the kernel send buffer, in bytes (0 for the system default)
+    uint32_t send_buffer;
+};
+
 bool
 net_init(void);
 
@@ -44,6 +54,18 @@ net_listen(sc_socket server_socket, uint32_t addr, uint16_t port, int backlog);
 sc_socket
 net_accept(sc_socket server_socket);
 
+// Apply low-latency options to a connected socket
+// Failures are logged but not fatal: the socket is still usable.
+bool
+net_set_tuning(sc_socket socket, const struct sc_socket_tuning *tuning);
+
+// Acknowledge the next incoming segments immediately (Linux only, no-op
+// elsewhere)
+// This is not permanent: the kernel may leave quickack mode on its own, so the
+// receiving side must call it again after each receive.
+bool
+net_set_quickack(sc_socket socket);
+
 // the _all versions wait/retry until len bytes have been written/read
 ssize_t
 net_recv(sc_socket socket, void *buf, size_t len);
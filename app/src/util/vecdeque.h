@@ -351,6 +351,19 @@ sc_vecdeque_growsize_(size_t value)
     ok; \
 })
 
+/**
+ * Return a pointer to the item at a given index (0 is the oldest item)
+ *
+ * The item stays in the VecDeque, and may be modified in place.
+ *
+ * It is an error to call this function with an index out of bounds.
+ */
+#define sc_vecdeque_getref(pv, index) \
+({ \
+    assert((index) < (pv)->size); \
+    &(pv)->data[((pv)->origin + (index)) % (pv)->cap]; \
+})
+
 /**
  * Pop an item and return a pointer to it (still in the VecDeque)
  *
@@ -146,7 +146,7 @@ sc_v4l2_sink_open(struct sc_v4l2_sink *vs, const AVCodecContext *ctx) {
     assert(ctx->pix_fmt == AV_PIX_FMT_YUV420P);
     (void) ctx;
 
-    bool ok = sc_frame_buffer_init(&vs->fb);
+    bool ok = sc_frame_buffer_init(&vs->fb, 1);
     if (!ok) {
         return false;
     }
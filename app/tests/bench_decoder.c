@@ -0,0 +1,219 @@
+#include "common.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <libavcodec/avcodec.h>
+
+#include "decoder.h"
+#include "packet_header.h"
+#include "packet_merger.h"
+#include "trait/frame_sink.h"
+#include "util/binary.h"
+#include "util/histogram.h"
+#include "util/tick.h"
+
+// Decode a raw video stream, as received on the video socket (codec id,
+// video size, then packets prefixed by a 12-byte header, see
+// packet_header.h), and report the decoding performance.
+//
+// Usage: bench_decoder <file> [<threads>]
+//
+// The file may also be provided by the SCRCPY_BENCH_STREAM environment
+// variable (for "meson test --benchmark"). Threads is 0 (automatic) by
+// default, like --video-decoder-threads.
+
+// Exit code for a skipped test/benchmark
+#define SKIP 77
+
+struct null_sink {
+    struct sc_frame_sink frame_sink;
+    uint64_t frames;
+};
+
+static bool
+null_sink_open(struct sc_frame_sink *sink, const AVCodecContext *ctx) {
+    (void) sink;
+    (void) ctx;
+    return true;
+}
+
+static void
+null_sink_close(struct sc_frame_sink *sink) {
+    (void) sink;
+}
+
+static bool
+null_sink_push(struct sc_frame_sink *sink, const AVFrame *frame) {
+    (void) frame;
+    struct null_sink *ns = container_of(sink, struct null_sink, frame_sink);
+    ++ns->frames;
+    return true;
+}
+
+static bool
+read_packet(FILE *file, AVPacket *packet) {
+    uint8_t header[SC_PACKET_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        return false;
+    }
+
+    uint64_t pts_flags;
+    uint32_t len = sc_packet_header_read(header, &pts_flags);
+    if (!len || av_new_packet(packet, len)) {
+        return false;
+    }
+
+    if (fread(packet->data, 1, len, file) != len) {
+        av_packet_unref(packet);
+        return false;
+    }
+
+    sc_packet_header_apply(packet, pts_flags);
+    return true;
+}
+
+static int
+bench(FILE *file, unsigned threads) {
+    uint8_t header[12];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        fprintf(stderr, "Could not read stream header\n");
+        return 1;
+    }
+
+    uint32_t raw_codec_id = sc_read32be(header);
+    enum AVCodecID codec_id = sc_packet_header_to_avcodec_id(raw_codec_id);
+    if (codec_id == AV_CODEC_ID_NONE
+            || avcodec_get_type(codec_id) != AVMEDIA_TYPE_VIDEO) {
+        fprintf(stderr, "Unsupported video codec 0x%08" PRIx32 "\n",
+                raw_codec_id);
+        return 1;
+    }
+
+    const AVCodec *codec = avcodec_find_decoder(codec_id);
+    if (!codec) {
+        fprintf(stderr, "Missing decoder\n");
+        return 1;
+    }
+
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    if (!ctx) {
+        return 1;
+    }
+
+    // Same configuration as run_demuxer()
+    ctx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    ctx->width = sc_read32be(&header[4]);
+    ctx->height = sc_read32be(&header[8]);
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    sc_decoder_configure_threads(ctx, threads);
+
+    int ret = 1;
+
+    if (avcodec_open2(ctx, codec, NULL) < 0) {
+        fprintf(stderr, "Could not open codec\n");
+        goto free_context;
+    }
+
+    static const struct sc_frame_sink_ops null_sink_ops = {
+        .open = null_sink_open,
+        .close = null_sink_close,
+        .push = null_sink_push,
+    };
+    struct null_sink null_sink = {
+        .frame_sink.ops = &null_sink_ops,
+        .frames = 0,
+    };
+
+    struct sc_decoder decoder;
+    sc_decoder_init(&decoder, "video");
+    sc_frame_source_add_sink(&decoder.frame_source, &null_sink.frame_sink);
+
+    struct sc_packet_sink *sink = &decoder.packet_sink;
+    if (!sink->ops->open(sink, ctx)) {
+        goto free_context;
+    }
+
+    bool must_merge_config_packet = raw_codec_id == SC_CODEC_ID_H264
+                                 || raw_codec_id == SC_CODEC_ID_H265;
+    struct sc_packet_merger merger;
+    sc_packet_merger_init(&merger);
+
+    AVPacket *packet = av_packet_alloc();
+    if (!packet) {
+        goto close_sink;
+    }
+
+    struct sc_histogram histogram;
+    sc_histogram_reset(&histogram);
+    sc_tick total = 0;
+
+    // Only the decoding is measured, not the file reading
+    while (read_packet(file, packet)) {
+        if (must_merge_config_packet
+                && !sc_packet_merger_merge(&merger, packet)) {
+            av_packet_unref(packet);
+            goto free_packet;
+        }
+
+        uint64_t frames = null_sink.frames;
+        sc_tick start = sc_tick_now();
+        bool ok = sink->ops->push(sink, packet);
+        sc_tick duration = sc_tick_now() - start;
+        av_packet_unref(packet);
+        if (!ok) {
+            goto free_packet;
+        }
+
+        total += duration;
+        if (null_sink.frames != frames) {
+            sc_histogram_add(&histogram, duration);
+        }
+    }
+
+    bool sliced = ctx->active_thread_type & FF_THREAD_SLICE;
+    printf("%s %dx%d, %s decoding (%d threads)\n", codec->name, ctx->width,
+           ctx->height, sliced ? "slice-threaded" : "single-threaded",
+           sliced ? ctx->thread_count : 1);
+    printf("%" PRIu64 " frames in %" PRItick " ms: %.1f fps\n",
+           null_sink.frames, SC_TICK_TO_MS(total),
+           total ? (double) null_sink.frames * SC_TICK_FREQ / total : 0);
+    printf("decode time (us): p50=%" PRItick " p90=%" PRItick
+           " p99=%" PRItick " max=%" PRItick "\n",
+           SC_TICK_TO_US(sc_histogram_percentile(&histogram, 50)),
+           SC_TICK_TO_US(sc_histogram_percentile(&histogram, 90)),
+           SC_TICK_TO_US(sc_histogram_percentile(&histogram, 99)),
+           SC_TICK_TO_US(histogram.max));
+
+    ret = 0;
+
+free_packet:
+    av_packet_free(&packet);
+close_sink:
+    sc_packet_merger_destroy(&merger);
+    sink->ops->close(sink);
+free_context:
+    avcodec_free_context(&ctx);
+    return ret;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : getenv("SCRCPY_BENCH_STREAM");
+    if (!path) {
+        fprintf(stderr, "No stream file (pass it as argument or set "
+                        "SCRCPY_BENCH_STREAM)\n");
+        return SKIP;
+    }
+
+    unsigned threads = argc > 2 ? strtoul(argv[2], NULL, 10) : 0;
+
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return 1;
+    }
+
+    int ret = bench(file, threads);
+    fclose(file);
+    return ret;
+}
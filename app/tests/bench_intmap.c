@@ -0,0 +1,70 @@
+#include "common.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "keyboard_inject_keys.h"
+#include "util/intmap.h"
+#include "util/tick.h"
+
+#define ITERATIONS 200000
+
+// Every key of the tables walked by convert_keycode() in raw mode: the
+// numbers and punctuation keys miss the first table
+static int32_t keys[ARRAY_LEN(sc_alphaspace_keys)
+                    + ARRAY_LEN(sc_numbers_punct_keys)];
+
+static void
+init_keys(void) {
+    size_t n = 0;
+    for (size_t i = 0; i < ARRAY_LEN(sc_alphaspace_keys); ++i) {
+        keys[n++] = sc_alphaspace_keys[i].key;
+    }
+    for (size_t i = 0; i < ARRAY_LEN(sc_numbers_punct_keys); ++i) {
+        keys[n++] = sc_numbers_punct_keys[i].key;
+    }
+}
+
+typedef const struct sc_intmap_entry *
+(*find_fn)(const struct sc_intmap_entry entries[], size_t len, int32_t key);
+
+static void
+bench(const char *name, find_fn find) {
+    volatile int32_t sink = 0;
+
+    sc_tick start = sc_tick_now();
+    for (unsigned i = 0; i < ITERATIONS; ++i) {
+        for (size_t j = 0; j < ARRAY_LEN(keys); ++j) {
+            // Same lookup sequence as convert_keycode()
+            const struct sc_intmap_entry *entry =
+                find(sc_alphaspace_keys, ARRAY_LEN(sc_alphaspace_keys),
+                     keys[j]);
+            if (!entry) {
+                entry = find(sc_numbers_punct_keys,
+                             ARRAY_LEN(sc_numbers_punct_keys), keys[j]);
+            }
+            if (entry) {
+                sink += entry->value;
+            }
+        }
+    }
+    sc_tick duration = sc_tick_now() - start;
+
+    uint64_t lookups = (uint64_t) ITERATIONS * ARRAY_LEN(keys);
+    printf("%-8s %" PRIu64 " keys in %" PRItick " ms (%.2f ns/key)\n",
+           name, lookups, SC_TICK_TO_MS(duration),
+           (double) SC_TICK_TO_NS(duration) / lookups);
+    (void) sink;
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    init_keys();
+
+    bench("linear", sc_intmap_find_entry);
+    bench("sorted", sc_intmap_find_entry_sorted);
+
+    return 0;
+}
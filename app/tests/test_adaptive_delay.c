@@ -0,0 +1,95 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "adaptive_delay.h"
+
+#define MS SC_TICK_FROM_MS
+
+static struct sc_adaptive_delay ad;
+
+static void test_adaptive_delay_clean_link(void) {
+    sc_adaptive_delay_init(&ad, MS(10), MS(200));
+    assert(ad.target == MS(10));
+
+    // constant transit time: no jitter, the target stays at the minimum
+    for (int i = 0; i < 100; ++i) {
+        sc_tick stream = i * MS(16);
+        assert(!sc_adaptive_delay_on_arrival(&ad, stream + MS(50), stream));
+    }
+    assert(ad.jitter == 0);
+    assert(ad.target == MS(10));
+}
+
+static void test_adaptive_delay_jitter(void) {
+    sc_adaptive_delay_init(&ad, MS(10), MS(200));
+
+    // transit alternates between 20 and 60 ms
+    for (int i = 0; i < 200; ++i) {
+        sc_tick stream = i * MS(16);
+        sc_tick transit = i % 2 ? MS(60) : MS(20);
+        sc_adaptive_delay_on_arrival(&ad, stream + transit, stream);
+    }
+
+    // the jitter converges towards 40 ms
+    assert(ad.jitter > MS(35) && ad.jitter <= MS(40));
+    assert(ad.target == 4 * ad.jitter);
+}
+
+static void test_adaptive_delay_max(void) {
+    sc_adaptive_delay_init(&ad, MS(10), MS(50));
+
+    for (int i = 0; i < 200; ++i) {
+        sc_tick stream = i * MS(16);
+        sc_tick transit = i % 2 ? MS(100) : MS(0);
+        sc_adaptive_delay_on_arrival(&ad, stream + transit, stream);
+    }
+    assert(ad.target == MS(50));
+
+    assert(!sc_adaptive_delay_on_late(&ad, MS(10000), MS(30)));
+    assert(ad.target == MS(50));
+}
+
+static void test_adaptive_delay_late(void) {
+    sc_adaptive_delay_init(&ad, MS(10), MS(200));
+
+    sc_tick now = MS(1000);
+    assert(sc_adaptive_delay_on_arrival(&ad, now, 0) == false);
+
+    // a late frame increases the target immediately
+    assert(sc_adaptive_delay_on_late(&ad, now, MS(15)));
+    assert(ad.target == MS(25));
+
+    // the target is kept for a while
+    sc_tick stream = 0;
+    for (; stream < SC_TICK_FROM_SEC(4); stream += MS(16)) {
+        assert(!sc_adaptive_delay_on_arrival(&ad, now + stream, stream));
+    }
+    assert(ad.target == MS(25));
+
+    // then it decreases slowly back to the minimum
+    bool decreased = false;
+    for (; stream < SC_TICK_FROM_SEC(60); stream += MS(16)) {
+        sc_tick previous = ad.target;
+        if (sc_adaptive_delay_on_arrival(&ad, now + stream, stream)) {
+            assert(ad.target < previous);
+            // at most 1/4 of the excess per step
+            assert(previous - ad.target <= (previous - MS(10) + 3) / 4);
+            decreased = true;
+        }
+    }
+    assert(decreased);
+    assert(ad.target == MS(10));
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_adaptive_delay_clean_link();
+    test_adaptive_delay_jitter();
+    test_adaptive_delay_max();
+    test_adaptive_delay_late();
+
+    return 0;
+}
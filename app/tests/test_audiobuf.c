@@ -0,0 +1,224 @@
+#include "common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "util/audiobuf.h"
+#include "util/thread.h"
+
+static void test_audiobuf_simple(void) {
+    struct sc_audiobuf buf;
+    uint32_t data[20];
+
+    bool ok = sc_audiobuf_init(&buf, 4, 7);
+    assert(ok);
+    assert(sc_audiobuf_capacity(&buf) == 7);
+    assert(sc_audiobuf_can_read(&buf) == 0);
+    assert(sc_audiobuf_can_write(&buf) == 7);
+
+    static const uint32_t samples1[] = {1, 2, 3, 4};
+    uint32_t w = sc_audiobuf_write(&buf, samples1, 4);
+    assert(w == 4);
+    assert(sc_audiobuf_can_read(&buf) == 4);
+    assert(sc_audiobuf_can_write(&buf) == 3);
+
+    uint32_t r = sc_audiobuf_read(&buf, data, 3);
+    assert(r == 3);
+    assert(!memcmp(data, samples1, 3 * sizeof(uint32_t)));
+    assert(sc_audiobuf_can_read(&buf) == 1);
+
+    // wrap around the end of the internal buffer
+    static const uint32_t samples2[] = {5, 6, 7, 8, 9, 10};
+    w = sc_audiobuf_write(&buf, samples2, 6);
+    assert(w == 6);
+    assert(sc_audiobuf_can_read(&buf) == 7);
+    assert(sc_audiobuf_can_write(&buf) == 0);
+
+    r = sc_audiobuf_read(&buf, data, 7);
+    assert(r == 7);
+    static const uint32_t expected[] = {4, 5, 6, 7, 8, 9, 10};
+    assert(!memcmp(data, expected, sizeof(expected)));
+    assert(sc_audiobuf_can_read(&buf) == 0);
+
+    sc_audiobuf_destroy(&buf);
+}
+
+static void test_audiobuf_partial(void) {
+    struct sc_audiobuf buf;
+    uint32_t data[20];
+
+    bool ok = sc_audiobuf_init(&buf, 4, 5);
+    assert(ok);
+
+    static const uint32_t samples[] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+    // only the samples which fit are written
+    uint32_t w = sc_audiobuf_write(&buf, samples, 8);
+    assert(w == 5);
+    assert(sc_audiobuf_can_write(&buf) == 0);
+    assert(sc_audiobuf_write(&buf, samples, 1) == 0);
+
+    uint32_t skipped = sc_audiobuf_skip(&buf, 3);
+    assert(skipped == 3);
+    assert(sc_audiobuf_can_read(&buf) == 2);
+
+    w = sc_audiobuf_write(&buf, &samples[5], 3);
+    assert(w == 3);
+
+    // only the available samples are read
+    uint32_t r = sc_audiobuf_read(&buf, data, 20);
+    assert(r == 5);
+    assert(!memcmp(data, &samples[3], 5 * sizeof(uint32_t)));
+
+    assert(sc_audiobuf_read(&buf, data, 1) == 0);
+    assert(sc_audiobuf_skip(&buf, 1) == 0);
+
+    sc_audiobuf_destroy(&buf);
+}
+
+static void test_audiobuf_write_area(void) {
+    struct sc_audiobuf buf;
+    uint32_t data[20];
+
+    bool ok = sc_audiobuf_init(&buf, 4, 5);
+    assert(ok);
+
+    static const uint32_t samples[] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint32_t w = sc_audiobuf_write(&buf, samples, 4);
+    assert(w == 4);
+    uint32_t r = sc_audiobuf_read(&buf, data, 3);
+    assert(r == 3);
+
+    // the free space is split around the end of the buffer
+    void *area;
+    uint32_t count = sc_audiobuf_write_area(&buf, &area);
+    assert(count == 2);
+    memcpy(area, &samples[4], 2 * sizeof(uint32_t));
+    sc_audiobuf_commit_write(&buf, 2);
+
+    count = sc_audiobuf_write_area(&buf, &area);
+    assert(count == 2);
+    memcpy(area, &samples[6], 2 * sizeof(uint32_t));
+    sc_audiobuf_commit_write(&buf, 2);
+
+    assert(sc_audiobuf_write_area(&buf, &area) == 0);
+
+    r = sc_audiobuf_read(&buf, data, 20);
+    assert(r == 5);
+    assert(!memcmp(data, &samples[3], 5 * sizeof(uint32_t)));
+
+    sc_audiobuf_destroy(&buf);
+}
+
+static void test_audiobuf_make_room(void) {
+    struct sc_audiobuf buf;
+    uint32_t data[20];
+
+    bool ok = sc_audiobuf_init(&buf, 4, 7);
+    assert(ok);
+
+    static const uint32_t samples[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+
+    // enough space, nothing is dropped
+    uint32_t w = sc_audiobuf_write(&buf, samples, 5);
+    assert(w == 5);
+    assert(sc_audiobuf_make_room(&buf, 2) == 0);
+    assert(sc_audiobuf_can_read(&buf) == 5);
+
+    // the oldest samples are dropped, the new ones are written entirely
+    uint32_t dropped = sc_audiobuf_make_room(&buf, 4);
+    assert(dropped == 2);
+    w = sc_audiobuf_write(&buf, &samples[5], 4);
+    assert(w == 4);
+    assert(sc_audiobuf_can_write(&buf) == 0);
+
+    uint32_t r = sc_audiobuf_read(&buf, data, 20);
+    assert(r == 7);
+    assert(!memcmp(data, &samples[2], 7 * sizeof(uint32_t)));
+
+    // a write larger than the capacity drops all the buffered samples
+    w = sc_audiobuf_write(&buf, samples, 3);
+    assert(w == 3);
+    dropped = sc_audiobuf_make_room(&buf, 9);
+    assert(dropped == 3);
+    w = sc_audiobuf_write(&buf, &samples[3], 9);
+    assert(w == 7);
+
+    r = sc_audiobuf_read(&buf, data, 20);
+    assert(r == 7);
+    assert(!memcmp(data, &samples[3], 7 * sizeof(uint32_t)));
+
+    sc_audiobuf_destroy(&buf);
+}
+
+#define CONCURRENT_SAMPLES 200000
+
+static int run_producer(void *data) {
+    struct sc_audiobuf *buf = data;
+
+    uint32_t samples[23];
+    uint32_t next = 0;
+    while (next < CONCURRENT_SAMPLES) {
+        // vary the chunk size, so that the cursors wrap at various positions
+        uint32_t count = 1 + next % 23;
+        if (count > CONCURRENT_SAMPLES - next) {
+            count = CONCURRENT_SAMPLES - next;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            samples[i] = next + i;
+        }
+
+        uint32_t written = 0;
+        while (written < count) {
+            written += sc_audiobuf_write(buf, &samples[written],
+                                         count - written);
+        }
+        next += count;
+    }
+
+    return 0;
+}
+
+static void test_audiobuf_concurrent(void) {
+    struct sc_audiobuf buf;
+    bool ok = sc_audiobuf_init(&buf, 4, 1021);
+    assert(ok);
+
+    sc_thread producer;
+    ok = sc_thread_create(&producer, run_producer, "test-producer", &buf);
+    assert(ok);
+
+    // the samples must be received in order, without loss or corruption
+    uint64_t checksum = 0;
+    uint32_t expected = 0;
+    uint32_t samples[17];
+    while (expected < CONCURRENT_SAMPLES) {
+        uint32_t r = sc_audiobuf_read(&buf, samples, 1 + expected % 17);
+        for (uint32_t i = 0; i < r; ++i) {
+            assert(samples[i] == expected);
+            checksum += samples[i];
+            ++expected;
+        }
+    }
+
+    sc_thread_join(&producer, NULL);
+
+    assert(sc_audiobuf_can_read(&buf) == 0);
+    uint64_t n = CONCURRENT_SAMPLES;
+    assert(checksum == n * (n - 1) / 2);
+
+    sc_audiobuf_destroy(&buf);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_audiobuf_simple();
+    test_audiobuf_partial();
+    test_audiobuf_write_area();
+    test_audiobuf_make_room();
+    test_audiobuf_concurrent();
+
+    return 0;
+}
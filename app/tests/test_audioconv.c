@@ -0,0 +1,78 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "util/audioconv.h"
+
+static void test_audioconv_interleave_stereo(void) {
+    float left[11];
+    float right[11];
+    for (int i = 0; i < 11; ++i) {
+        left[i] = i;
+        right[i] = -i;
+    }
+    const float *const src[] = {left, right};
+
+    float dst[22];
+    // Not aligned, with a non-vectorized tail
+    sc_audioconv_interleave_f32(dst, src, 2, 1, 10);
+    for (int i = 0; i < 10; ++i) {
+        assert(dst[2 * i] == i + 1);
+        assert(dst[2 * i + 1] == -(i + 1));
+    }
+}
+
+static void test_audioconv_interleave_multichannel(void) {
+    float c0[] = {0, 1, 2, 3, 4};
+    float c1[] = {10, 11, 12, 13, 14};
+    float c2[] = {20, 21, 22, 23, 24};
+    const float *const src[] = {c0, c1, c2};
+
+    float dst[15];
+    sc_audioconv_interleave_f32(dst, src, 3, 0, 5);
+    for (int i = 0; i < 5; ++i) {
+        assert(dst[3 * i] == i);
+        assert(dst[3 * i + 1] == 10 + i);
+        assert(dst[3 * i + 2] == 20 + i);
+    }
+
+    // mono
+    sc_audioconv_interleave_f32(dst, src, 1, 2, 3);
+    assert(dst[0] == 2);
+    assert(dst[1] == 3);
+    assert(dst[2] == 4);
+}
+
+static void test_audioconv_s16(void) {
+    int16_t src[22];
+    for (int i = 0; i < 22; ++i) {
+        src[i] = (i - 11) * 3000;
+    }
+    src[0] = INT16_MIN;
+    src[21] = INT16_MAX;
+
+    float dst[22];
+    sc_audioconv_s16_to_f32(dst, src, 2, 0, 11);
+    for (int i = 0; i < 22; ++i) {
+        assert(dst[i] == src[i] / 32768.0f);
+    }
+    assert(dst[0] == -1.0f);
+    assert(dst[21] < 1.0f);
+
+    // from the second stereo sample
+    sc_audioconv_s16_to_f32(dst, src, 2, 1, 10);
+    for (int i = 0; i < 20; ++i) {
+        assert(dst[i] == src[i + 2] / 32768.0f);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_audioconv_interleave_stereo();
+    test_audioconv_interleave_multichannel();
+    test_audioconv_s16();
+
+    return 0;
+}
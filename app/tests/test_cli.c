@@ -123,6 +123,54 @@ static void test_options2(void) {
     assert(opts->record_format == SC_RECORD_FORMAT_MP4);
 }
 
+static void test_frame_policy(void) {
+    struct scrcpy_cli_args args = {
+        .opts = scrcpy_options_default,
+        .help = false,
+        .version = false,
+    };
+
+    char *argv[] = {
+        "scrcpy",
+        "--frame-policy=decode-drop",
+    };
+
+    bool ok = scrcpy_parse_args(&args, ARRAY_LEN(argv), argv);
+    assert(ok);
+    assert(args.opts.frame_policy == SC_FRAME_POLICY_DECODE_DROP);
+
+    // the decoder could never know that the frames are late
+    args.opts = scrcpy_options_default;
+    char *argv2[] = {
+        "scrcpy",
+        "--frame-policy=decode-drop",
+        "--display-buffer=50",
+    };
+
+    ok = scrcpy_parse_args(&args, ARRAY_LEN(argv2), argv2);
+    assert(!ok);
+
+    args.opts = scrcpy_options_default;
+    char *argv3[] = {
+        "scrcpy",
+        "--frame-policy=ring",
+    };
+
+    ok = scrcpy_parse_args(&args, ARRAY_LEN(argv3), argv3);
+    assert(ok);
+    assert(args.opts.frame_ring_size == 3);
+
+    // the ring size is only used by the ring policy
+    args.opts = scrcpy_options_default;
+    char *argv4[] = {
+        "scrcpy",
+        "--frame-ring-size=4",
+    };
+
+    ok = scrcpy_parse_args(&args, ARRAY_LEN(argv4), argv4);
+    assert(!ok);
+}
+
 static void test_parse_shortcut_mods(void) {
     struct sc_shortcut_mods mods;
     bool ok;
@@ -169,6 +217,7 @@ int main(int argc, char *argv[]) {
     test_flag_help();
     test_options();
     test_options2();
+    test_frame_policy();
     test_parse_shortcut_mods();
     return 0;
 }
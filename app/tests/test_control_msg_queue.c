@@ -0,0 +1,159 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "control_msg_queue.h"
+
+#define QUEUE_MAX 4
+
+static struct sc_control_msg
+touch(enum android_motionevent_action action, uint64_t pointer_id,
+      int32_t x, int32_t y) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT,
+        .inject_touch_event = {
+            .action = action,
+            .pointer_id = pointer_id,
+            .position = {
+                .screen_size = {1080, 1920},
+                .point = {x, y},
+            },
+            .pressure = 1.0f,
+        },
+    };
+    return msg;
+}
+
+static struct sc_control_msg
+keycode(enum android_keyevent_action action) {
+    struct sc_control_msg msg = {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_KEYCODE,
+        .inject_keycode = {
+            .action = action,
+            .keycode = AKEYCODE_A,
+        },
+    };
+    return msg;
+}
+
+static void
+init_queue(struct sc_control_msg_queue *queue) {
+    sc_vecdeque_init(queue);
+    bool ok = sc_vecdeque_reserve(queue, QUEUE_MAX);
+    assert(ok);
+}
+
+static struct sc_control_msg *
+get(struct sc_control_msg_queue *queue, size_t index) {
+    return sc_vecdeque_getref(queue, index);
+}
+
+static void test_control_msg_queue_coalesce_move(void) {
+    struct sc_control_msg_queue queue;
+    init_queue(&queue);
+
+    struct sc_control_msg msg = touch(AMOTION_EVENT_ACTION_DOWN, 1, 10, 10);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    msg = touch(AMOTION_EVENT_ACTION_MOVE, 1, 20, 20);
+    msg.timestamp = 42;
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    // another pointer in between does not prevent merging
+    msg = touch(AMOTION_EVENT_ACTION_MOVE, 2, 100, 100);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    assert(sc_vecdeque_size(&queue) == 3);
+
+    msg = touch(AMOTION_EVENT_ACTION_MOVE, 1, 30, 30);
+    msg.timestamp = 43;
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+
+    // merged into the pending MOVE of pointer 1
+    assert(sc_vecdeque_size(&queue) == 3);
+    struct sc_control_msg *pending = get(&queue, 1);
+    assert(pending->inject_touch_event.pointer_id == 1);
+    assert(pending->inject_touch_event.position.point.x == 30);
+    assert(pending->inject_touch_event.position.point.y == 30);
+    // the pending message keeps its timestamp
+    assert(pending->timestamp == 42);
+
+    // the MOVE of pointer 2 is unchanged
+    pending = get(&queue, 2);
+    assert(pending->inject_touch_event.pointer_id == 2);
+    assert(pending->inject_touch_event.position.point.x == 100);
+
+    sc_vecdeque_destroy(&queue);
+}
+
+static void test_control_msg_queue_no_merge_across_down_up(void) {
+    struct sc_control_msg_queue queue;
+    init_queue(&queue);
+
+    struct sc_control_msg msg = touch(AMOTION_EVENT_ACTION_MOVE, 1, 10, 10);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    msg = touch(AMOTION_EVENT_ACTION_UP, 1, 10, 10);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    msg = touch(AMOTION_EVENT_ACTION_DOWN, 1, 50, 50);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+
+    // the MOVE must not be merged across the UP and the DOWN
+    msg = touch(AMOTION_EVENT_ACTION_MOVE, 1, 60, 60);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    assert(sc_vecdeque_size(&queue) == 4);
+
+    assert(get(&queue, 0)->inject_touch_event.position.point.x == 10);
+    assert(get(&queue, 1)->inject_touch_event.action
+            == AMOTION_EVENT_ACTION_UP);
+    assert(get(&queue, 2)->inject_touch_event.action
+            == AMOTION_EVENT_ACTION_DOWN);
+    assert(get(&queue, 3)->inject_touch_event.action
+            == AMOTION_EVENT_ACTION_MOVE);
+    assert(get(&queue, 3)->inject_touch_event.position.point.x == 60);
+
+    sc_vecdeque_destroy(&queue);
+}
+
+static void test_control_msg_queue_full(void) {
+    struct sc_control_msg_queue queue;
+    init_queue(&queue);
+
+    for (int i = 0; i < QUEUE_MAX; ++i) {
+        struct sc_control_msg msg = keycode(AKEY_EVENT_ACTION_DOWN);
+        assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    }
+    assert(sc_vecdeque_size(&queue) == QUEUE_MAX);
+
+    // a MOVE which cannot be merged is dropped when the queue is full
+    struct sc_control_msg msg = touch(AMOTION_EVENT_ACTION_MOVE, 1, 10, 10);
+    assert(!sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    assert(sc_vecdeque_size(&queue) == QUEUE_MAX);
+
+    // a scroll event too
+    msg = (struct sc_control_msg) {
+        .type = SC_CONTROL_MSG_TYPE_INJECT_SCROLL_EVENT,
+    };
+    assert(!sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    assert(sc_vecdeque_size(&queue) == QUEUE_MAX);
+
+    // a non-droppable message grows the queue
+    msg = touch(AMOTION_EVENT_ACTION_DOWN, 1, 10, 10);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    msg = keycode(AKEY_EVENT_ACTION_UP);
+    assert(sc_control_msg_queue_push(&queue, &msg, QUEUE_MAX));
+    assert(sc_vecdeque_size(&queue) == QUEUE_MAX + 2);
+    assert(get(&queue, QUEUE_MAX)->type
+            == SC_CONTROL_MSG_TYPE_INJECT_TOUCH_EVENT);
+    assert(get(&queue, QUEUE_MAX + 1)->type
+            == SC_CONTROL_MSG_TYPE_INJECT_KEYCODE);
+
+    sc_vecdeque_destroy(&queue);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_control_msg_queue_coalesce_move();
+    test_control_msg_queue_no_merge_across_down_up();
+    test_control_msg_queue_full();
+
+    return 0;
+}
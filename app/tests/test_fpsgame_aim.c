@@ -0,0 +1,165 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "keymap/fpsgame_aim.h"
+
+static struct sc_fpsgame_aim aim;
+
+static void test_linear(void) {
+    sc_fpsgame_aim_init(&aim);
+
+    float dx;
+    float dy;
+    sc_fpsgame_aim_apply(&aim, 4, -2, 0.5f, 0.25f, &dx, &dy);
+    assert(dx == 2.f);
+    assert(dy == -0.5f);
+
+    // very fast movements use the last entry of the table
+    sc_fpsgame_aim_apply(&aim, 10000, 0, 1.f, 1.f, &dx, &dy);
+    assert(dx == 10000.f);
+}
+
+static void test_power(void) {
+    sc_fpsgame_aim_init(&aim);
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCurve", "power"));
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimExponent", "2"));
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimMaxGain", "3"));
+
+    assert(aim.lut[1] == 1.f);
+    assert(aim.lut[2] == 2.f);
+    assert(aim.lut[3] == 3.f);
+    assert(aim.lut[4] == 3.f); // capped
+
+    float dx;
+    float dy;
+    sc_fpsgame_aim_apply(&aim, 0, 2, 1.f, 1.f, &dx, &dy);
+    assert(dx == 0.f);
+    assert(dy == 4.f);
+}
+
+static void test_table(void) {
+    sc_fpsgame_aim_init(&aim);
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCurve", "table"));
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCurveTable",
+                                        "2 0.5  10 2.5"));
+    assert(aim.table_len == 2);
+    assert(aim.lut[0] == 0.5f);
+    assert(aim.lut[2] == 0.5f);
+    assert(aim.lut[6] == 1.5f);
+    assert(aim.lut[10] == 2.5f);
+    assert(aim.lut[100] == 2.5f);
+
+    // speeds must be increasing, and a rejected table is not applied
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimCurveTable", "4 1 2 1"));
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimCurveTable", "4"));
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimCurveTable", ""));
+    assert(aim.table_len == 2);
+}
+
+static void test_ads(void) {
+    sc_fpsgame_aim_init(&aim);
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "adsSensitivity", "0.5"));
+    assert(sc_fpsgame_aim_parse_setting(&aim, "adsPointer", "20"));
+    assert(aim.ads_pointer_id == 20);
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "adsPointer", "256"));
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimUnknown", "1"));
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimRecenterRadius", "0.25"));
+    assert(aim.recenter_radius == 0.25f);
+
+    float dx;
+    float dy;
+    sc_fpsgame_aim_apply(&aim, 2, 2, 1.f, 1.f, &dx, &dy);
+    assert(dx == 2.f);
+
+    aim.ads = true;
+    sc_fpsgame_aim_apply(&aim, 2, 2, 1.f, 1.f, &dx, &dy);
+    assert(dx == 1.f);
+    assert(dy == 1.f);
+}
+
+static void test_coalesce(void) {
+    sc_fpsgame_aim_init(&aim);
+    assert(aim.coalesce == SC_FPSGAME_AIM_COALESCE_OFF);
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "vsync"));
+    assert(aim.coalesce == SC_FPSGAME_AIM_COALESCE_VSYNC);
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "4ms"));
+    assert(aim.coalesce == SC_FPSGAME_AIM_COALESCE_INTERVAL);
+    assert(aim.coalesce_interval == SC_TICK_FROM_MS(4));
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "250hz"));
+    assert(aim.coalesce_interval == SC_TICK_FROM_MS(4));
+
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "0ms"));
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "4"));
+    assert(!sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "4s"));
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCoalesce", "off"));
+    assert(aim.coalesce == SC_FPSGAME_AIM_COALESCE_OFF);
+}
+
+static void test_accumulate(void) {
+    sc_fpsgame_aim_init(&aim);
+
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimCurve", "power"));
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimExponent", "2"));
+    assert(sc_fpsgame_aim_parse_setting(&aim, "aimMaxGain", "3"));
+
+    static const int32_t events[][2] = {
+        {2, 0}, {2, 1}, {0, 2}, {-1, 2}, {3, 0}, {2, -2}, {1, 1}, {2, 0},
+    };
+
+    // uncoalesced: each event is applied and sent separately
+    float sent_x = 0;
+    float sent_y = 0;
+    for (unsigned i = 0; i < ARRAY_LEN(events); ++i) {
+        float dx;
+        float dy;
+        sc_fpsgame_aim_apply(&aim, events[i][0], events[i][1], 0.5f, 0.25f,
+                             &dx, &dy);
+        sent_x += dx;
+        sent_y += dy;
+    }
+
+    // coalesced: the events are accumulated, then sent at once
+    float coalesced_x = 0;
+    float coalesced_y = 0;
+    int32_t xrel = 0;
+    int32_t yrel = 0;
+    for (unsigned i = 0; i < ARRAY_LEN(events); ++i) {
+        sc_fpsgame_aim_accumulate(&aim, events[i][0], events[i][1], 0.5f,
+                                  0.25f, &coalesced_x, &coalesced_y);
+        xrel += events[i][0];
+        yrel += events[i][1];
+    }
+
+    // the total motion does not depend on the coalescing
+    assert(coalesced_x == sent_x);
+    assert(coalesced_y == sent_y);
+
+    // whereas applying the curve to the summed input would amplify it
+    float dx;
+    float dy;
+    sc_fpsgame_aim_apply(&aim, xrel, yrel, 0.5f, 0.25f, &dx, &dy);
+    assert(dx > sent_x);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_linear();
+    test_power();
+    test_table();
+    test_ads();
+    test_coalesce();
+    test_accumulate();
+
+    return 0;
+}
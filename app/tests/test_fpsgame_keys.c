@@ -0,0 +1,139 @@
+#include "common.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "keymap/fpsgame_keys.h"
+
+static struct sc_fpsgame_keys sfk;
+
+static void test_default_bindings(void) {
+    sc_fpsgame_keys_init(&sfk);
+
+    const struct sc_fpsgame_binding *w = &sfk.keys[SDL_SCANCODE_W];
+    assert(w->action == SC_FPSGAME_ACTION_JOYSTICK);
+    assert(w->pointer_id == SC_FPSGAME_POINTER_WHEEL);
+    assert(w->axis_x == 0);
+    assert(w->axis_y == -1);
+
+    const struct sc_fpsgame_binding *jump = &sfk.keys[SDL_SCANCODE_SPACE];
+    assert(jump->action == SC_FPSGAME_ACTION_HOLD);
+    assert(jump->pointer_id == 11);
+    assert(jump->x == 0.94f);
+    assert(jump->y == 0.7f);
+
+    const struct sc_fpsgame_binding *fire = &sfk.buttons[SDL_BUTTON_LEFT];
+    assert(fire->action == SC_FPSGAME_ACTION_HOLD);
+    assert(fire->pointer_id == 12);
+
+    assert(sfk.keys[SDL_SCANCODE_Y].action == SC_FPSGAME_ACTION_NONE);
+}
+
+static void test_parse_legacy(void) {
+    sc_fpsgame_keys_init(&sfk);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "speedRatioX:0.5\n"));
+    assert(sfk.speedRatioX == 0.5f);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "adsSensitivity:0.5"));
+    assert(sfk.aim.ads_sensitivity == 0.5f);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "jumpX:0.25"));
+    assert(sfk.keys[SDL_SCANCODE_SPACE].x == 0.25f);
+
+    // the same name may move several default bindings
+    assert(sc_fpsgame_keys_parse_line(&sfk, "punctuationY: 0.125"));
+    assert(sfk.keys[SDL_SCANCODE_B].y == 0.125f);
+    assert(sfk.buttons[SDL_BUTTON_MIDDLE].y == 0.125f);
+
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "unknownX:0.5"));
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "jumpX:abc"));
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "no separator"));
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, ""));
+    assert(sc_fpsgame_keys_parse_line(&sfk, "# comment"));
+}
+
+static void test_parse_bind(void) {
+    sc_fpsgame_keys_init(&sfk);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "bind.Y:tap 0.5 0.25 3"));
+    const struct sc_fpsgame_binding *y = &sfk.keys[SDL_SCANCODE_Y];
+    assert(y->action == SC_FPSGAME_ACTION_TAP);
+    assert(y->x == 0.5f);
+    assert(y->y == 0.25f);
+    assert(y->pointer_id == 3);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "bind.Left Shift:toggle 0.5 0.5 7"));
+    assert(sfk.keys[SDL_SCANCODE_LSHIFT].action == SC_FPSGAME_ACTION_TOGGLE);
+    assert(sfk.keys[SDL_SCANCODE_LSHIFT].pointer_id == 7);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "bind.Up:joystick 0 -1"));
+    assert(sfk.keys[SDL_SCANCODE_UP].action == SC_FPSGAME_ACTION_JOYSTICK);
+    assert(sfk.keys[SDL_SCANCODE_UP].axis_y == -1);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "bind.MouseX1:hold 0.1 0.2 15"));
+    assert(sfk.buttons[SDL_BUTTON_X1].action == SC_FPSGAME_ACTION_HOLD);
+    assert(sfk.buttons[SDL_BUTTON_X1].pointer_id == 15);
+
+    assert(sc_fpsgame_keys_parse_line(&sfk, "bind.Space:none"));
+    assert(sfk.keys[SDL_SCANCODE_SPACE].action == SC_FPSGAME_ACTION_NONE);
+
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "bind.NoSuchKey:tap 0.5 0.5 3"));
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "bind.Y:swipe 0.5 0.5 3"));
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "bind.Y:tap 0.5"));
+    assert(!sc_fpsgame_keys_parse_line(&sfk, "bind.Y:joystick 2 0"));
+
+    // a rejected line must not modify the existing binding
+    assert(sfk.keys[SDL_SCANCODE_Y].action == SC_FPSGAME_ACTION_TAP);
+}
+
+static void test_frame_point(void) {
+    sc_fpsgame_keys_init(&sfk);
+    const struct sc_fpsgame_binding *jump = &sfk.keys[SDL_SCANCODE_SPACE];
+
+    // The points are relative to the whole frame: with --render-roi, only
+    // the displayed area changes, so the same binding must give the same
+    // point whether the ROI is enabled or not.
+    struct sc_size frame_size = {2400, 1080};
+    struct sc_point p = sc_fpsgame_keys_to_frame_point(frame_size,
+                                                       SC_ORIENTATION_0,
+                                                       jump->x, jump->y);
+    assert(p.x == 2256);
+    assert(p.y == 756);
+
+    // The normalized coordinates follow the displayed (rotated) frame
+    p = sc_fpsgame_keys_to_frame_point(frame_size, SC_ORIENTATION_90,
+                                       jump->x, jump->y);
+    assert(p.x == 1680);
+    assert(p.y == 1080 - 1015);
+
+    p = sc_fpsgame_keys_to_frame_point(frame_size, SC_ORIENTATION_180,
+                                       jump->x, jump->y);
+    assert(p.x == 2400 - 2256);
+    assert(p.y == 1080 - 756);
+
+    struct sc_size size =
+        sc_fpsgame_keys_get_oriented_size(frame_size, SC_ORIENTATION_270);
+    assert(size.width == 1080);
+    assert(size.height == 2400);
+
+    // The corners of the displayed frame are the corners of the device frame
+    for (int o = SC_ORIENTATION_0; o <= SC_ORIENTATION_FLIP_270; ++o) {
+        p = sc_fpsgame_keys_to_frame_point(frame_size, o, 1, 1);
+        assert(p.x == 0 || p.x == 2400);
+        assert(p.y == 0 || p.y == 1080);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_default_bindings();
+    test_parse_legacy();
+    test_parse_bind();
+    test_frame_point();
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include "common.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <libavutil/frame.h>
+
+#include "frame_buffer.h"
+#include "util/thread.h"
+
+static AVFrame *new_frame(int64_t pts) {
+    AVFrame *frame = av_frame_alloc();
+    assert(frame);
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width = 16;
+    frame->height = 16;
+    int r = av_frame_get_buffer(frame, 0);
+    assert(!r);
+    frame->pts = pts;
+    return frame;
+}
+
+static void push(struct sc_frame_buffer *fb, int64_t pts, bool expect_skip) {
+    AVFrame *frame = new_frame(pts);
+    bool skipped;
+    bool ok = sc_frame_buffer_push(fb, frame, &skipped);
+    assert(ok);
+    assert(skipped == expect_skip);
+    // the buffer holds its own reference
+    av_frame_free(&frame);
+}
+
+static void consume(struct sc_frame_buffer *fb, AVFrame *dst,
+                    int64_t expected_pts) {
+    av_frame_unref(dst);
+    assert(sc_frame_buffer_has_pending(fb));
+    sc_frame_buffer_consume(fb, dst);
+    assert(dst->pts == expected_pts);
+    assert(dst->buf[0]);
+}
+
+// The back, front and ready frames are always the 3 distinct frames
+static void assert_triple_indices(struct sc_frame_buffer *fb) {
+    unsigned ready = atomic_load(&fb->triple.ready) & 3;
+    unsigned back = fb->triple.back;
+    unsigned front = fb->triple.front;
+    assert(back < 3 && front < 3 && ready < 3);
+    assert(back != front && back != ready && front != ready);
+}
+
+static void test_triple_rotation(void) {
+    struct sc_frame_buffer fb;
+    bool ok = sc_frame_buffer_init(&fb, 1);
+    assert(ok);
+
+    AVFrame *dst = av_frame_alloc();
+    assert(dst);
+
+    assert(!sc_frame_buffer_has_pending(&fb));
+    assert_triple_indices(&fb);
+
+    for (int64_t pts = 0; pts < 10; ++pts) {
+        unsigned back = fb.triple.back;
+        push(&fb, pts, false);
+        assert_triple_indices(&fb);
+        // the frame just written is now the ready frame
+        assert((atomic_load(&fb.triple.ready) & 3) == back);
+
+        unsigned front = fb.triple.front;
+        consume(&fb, dst, pts);
+        assert_triple_indices(&fb);
+        // the previous front frame is now the (empty) ready frame
+        assert(atomic_load(&fb.triple.ready) == front);
+        assert(!fb.frames[atomic_load(&fb.triple.ready)]->buf[0]);
+
+        assert(!sc_frame_buffer_has_pending(&fb));
+    }
+
+    av_frame_free(&dst);
+    sc_frame_buffer_destroy(&fb);
+}
+
+static void test_triple_skip(void) {
+    struct sc_frame_buffer fb;
+    bool ok = sc_frame_buffer_init(&fb, 1);
+    assert(ok);
+
+    AVFrame *dst = av_frame_alloc();
+    assert(dst);
+
+    // only the last frame is kept
+    push(&fb, 1, false);
+    push(&fb, 2, true);
+    push(&fb, 3, true);
+    assert_triple_indices(&fb);
+    consume(&fb, dst, 3);
+    assert(!sc_frame_buffer_has_pending(&fb));
+
+    // once consumed, the shared frame is not fresh anymore: pushing a new
+    // frame must not report a skip
+    push(&fb, 4, false);
+    consume(&fb, dst, 4);
+
+    av_frame_free(&dst);
+    sc_frame_buffer_destroy(&fb);
+}
+
+static void test_triple_consume_after_replace(void) {
+    struct sc_frame_buffer fb;
+    bool ok = sc_frame_buffer_init(&fb, 1);
+    assert(ok);
+
+    AVFrame *dst = av_frame_alloc();
+    assert(dst);
+
+    push(&fb, 1, false);
+    consume(&fb, dst, 1);
+
+    // the frame replaced before being consumed is dropped, the consumer gets
+    // the last one
+    push(&fb, 2, false);
+    push(&fb, 3, true);
+    consume(&fb, dst, 3);
+
+    // the consumed frame is still valid while new frames are pushed
+    AVFrame *held = av_frame_alloc();
+    assert(held);
+    av_frame_move_ref(held, dst);
+    push(&fb, 4, false);
+    push(&fb, 5, true);
+    assert(held->pts == 3);
+    assert(held->buf[0]);
+    consume(&fb, dst, 5);
+
+    av_frame_free(&held);
+    av_frame_free(&dst);
+    sc_frame_buffer_destroy(&fb);
+}
+
+static void test_ring_drop_oldest(void) {
+    struct sc_frame_buffer fb;
+    bool ok = sc_frame_buffer_init(&fb, 3);
+    assert(ok);
+
+    AVFrame *dst = av_frame_alloc();
+    assert(dst);
+
+    assert(!sc_frame_buffer_has_pending(&fb));
+
+    push(&fb, 1, false);
+    push(&fb, 2, false);
+    push(&fb, 3, false);
+    assert(fb.count == 3);
+
+    // the ring is full: the oldest frame is dropped
+    push(&fb, 4, true);
+    push(&fb, 5, true);
+    assert(fb.count == 3);
+
+    consume(&fb, dst, 3);
+    consume(&fb, dst, 4);
+
+    // wrap around the end of the ring
+    push(&fb, 6, false);
+    push(&fb, 7, false);
+    push(&fb, 8, true);
+    consume(&fb, dst, 6);
+    consume(&fb, dst, 7);
+    consume(&fb, dst, 8);
+    assert(!sc_frame_buffer_has_pending(&fb));
+
+    av_frame_free(&dst);
+    sc_frame_buffer_destroy(&fb);
+}
+
+#define CONCURRENT_FRAMES 200000
+
+struct concurrent_data {
+    struct sc_frame_buffer fb;
+    unsigned skipped;
+    atomic_bool done;
+};
+
+static int run_producer(void *userdata) {
+    struct concurrent_data *data = userdata;
+
+    for (int64_t pts = 0; pts < CONCURRENT_FRAMES; ++pts) {
+        AVFrame *frame = new_frame(pts);
+        // store the pts in the content, to detect a frame overwritten while
+        // it is held by the consumer
+        memcpy(frame->data[0], &pts, sizeof(pts));
+
+        bool skipped;
+        bool ok = sc_frame_buffer_push(&data->fb, frame, &skipped);
+        assert(ok);
+        if (skipped) {
+            ++data->skipped;
+        }
+        av_frame_free(&frame);
+    }
+
+    atomic_store(&data->done, true);
+    return 0;
+}
+
+static void test_triple_concurrent(void) {
+    struct concurrent_data data = {
+        .skipped = 0,
+    };
+    atomic_init(&data.done, false);
+
+    bool ok = sc_frame_buffer_init(&data.fb, 1);
+    assert(ok);
+
+    AVFrame *dst = av_frame_alloc();
+    assert(dst);
+
+    sc_thread producer;
+    ok = sc_thread_create(&producer, run_producer, "test-producer", &data);
+    assert(ok);
+
+    // the frames must be received in order, each one at most once
+    unsigned consumed = 0;
+    int64_t last_pts = -1;
+    for (;;) {
+        // read done before has_pending(), so that the last frame is not missed
+        bool done = atomic_load(&data.done);
+        if (!sc_frame_buffer_has_pending(&data.fb)) {
+            if (done) {
+                break;
+            }
+            continue;
+        }
+
+        sc_frame_buffer_consume(&data.fb, dst);
+        assert(dst->buf[0]);
+        assert(dst->pts > last_pts);
+        int64_t content;
+        memcpy(&content, dst->data[0], sizeof(content));
+        assert(content == dst->pts);
+        last_pts = dst->pts;
+        ++consumed;
+        av_frame_unref(dst);
+    }
+
+    sc_thread_join(&producer, NULL);
+
+    // the last frame is never dropped, and every frame not reported as
+    // skipped has been consumed
+    assert(last_pts == CONCURRENT_FRAMES - 1);
+    assert(consumed + data.skipped == CONCURRENT_FRAMES);
+
+    av_frame_free(&dst);
+    sc_frame_buffer_destroy(&data.fb);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_triple_rotation();
+    test_triple_skip();
+    test_triple_consume_after_replace();
+    test_ring_drop_oldest();
+    test_triple_concurrent();
+
+    return 0;
+}
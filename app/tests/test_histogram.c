@@ -0,0 +1,70 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "util/histogram.h"
+
+static struct sc_histogram h;
+
+static void test_histogram_empty(void) {
+    sc_histogram_reset(&h);
+    assert(h.count == 0);
+    assert(sc_histogram_percentile(&h, 50) == 0);
+}
+
+static void test_histogram_small_values(void) {
+    sc_histogram_reset(&h);
+
+    // values below 4 are exact
+    sc_histogram_add(&h, 1);
+    sc_histogram_add(&h, 2);
+    sc_histogram_add(&h, 3);
+    assert(h.count == 3);
+    assert(h.max == 3);
+    assert(sc_histogram_percentile(&h, 0) == 1);
+    assert(sc_histogram_percentile(&h, 50) == 2);
+    assert(sc_histogram_percentile(&h, 100) == 3);
+}
+
+static void test_histogram_percentiles(void) {
+    sc_histogram_reset(&h);
+
+    for (int i = 0; i < 99; ++i) {
+        sc_histogram_add(&h, 1000);
+    }
+    sc_histogram_add(&h, 50000);
+
+    // 1000 is in the bucket [896; 1023]
+    sc_tick p50 = sc_histogram_percentile(&h, 50);
+    assert(p50 >= 1000 && p50 <= 1000 * 5 / 4);
+    sc_tick p99 = sc_histogram_percentile(&h, 99);
+    assert(p99 == p50);
+
+    // the max is exact
+    assert(sc_histogram_percentile(&h, 100) == 50000);
+    assert(h.max == 50000);
+}
+
+static void test_histogram_huge_value(void) {
+    sc_histogram_reset(&h);
+
+    sc_histogram_add(&h, INT64_MAX);
+    assert(sc_histogram_percentile(&h, 50) <= INT64_MAX);
+    assert(h.max == INT64_MAX);
+
+    sc_histogram_add(&h, -1);
+    assert(h.count == 2);
+    assert(sc_histogram_percentile(&h, 0) == 0);
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_histogram_empty();
+    test_histogram_small_values();
+    test_histogram_percentiles();
+    test_histogram_huge_value();
+
+    return 0;
+}
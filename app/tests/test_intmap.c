@@ -0,0 +1,75 @@
+#include "common.h"
+
+#include <assert.h>
+
+#include "keyboard_inject_keys.h"
+#include "util/intmap.h"
+
+static const struct sc_intmap_entry sorted_map[] = {
+    {-5, 1},
+    {0, 2},
+    {3, 3},
+    {42, 4},
+    {0x4000004A, 5},
+    {0x400000E5, 6},
+};
+
+static void test_intmap_find_sorted(void) {
+    assert(sc_intmap_is_sorted(sorted_map, ARRAY_LEN(sorted_map)));
+
+    for (size_t i = 0; i < ARRAY_LEN(sorted_map); ++i) {
+        int32_t key = sorted_map[i].key;
+        const struct sc_intmap_entry *entry =
+            SC_INTMAP_FIND_ENTRY_SORTED(sorted_map, key);
+        assert(entry == &sorted_map[i]);
+        assert(entry == SC_INTMAP_FIND_ENTRY(sorted_map, key));
+    }
+
+    assert(!SC_INTMAP_FIND_ENTRY_SORTED(sorted_map, -6));
+    assert(!SC_INTMAP_FIND_ENTRY_SORTED(sorted_map, 1));
+    assert(!SC_INTMAP_FIND_ENTRY_SORTED(sorted_map, 43));
+    assert(!SC_INTMAP_FIND_ENTRY_SORTED(sorted_map, 0x7FFFFFFF));
+}
+
+static void test_intmap_find_sorted_empty(void) {
+    assert(sc_intmap_is_sorted(sorted_map, 0));
+    assert(!sc_intmap_find_entry_sorted(sorted_map, 0, 42));
+}
+
+static void test_intmap_is_sorted(void) {
+    struct sc_intmap_entry unsorted[] = {
+        {1, 0},
+        {3, 0},
+        {2, 0},
+    };
+    assert(!sc_intmap_is_sorted(unsorted, ARRAY_LEN(unsorted)));
+
+    // duplicate keys are not allowed
+    struct sc_intmap_entry duplicates[] = {
+        {1, 0},
+        {1, 0},
+    };
+    assert(!sc_intmap_is_sorted(duplicates, ARRAY_LEN(duplicates)));
+}
+
+static void test_intmap_keyboard_inject_keys_sorted(void) {
+    // The keyboard_inject.c lookups rely on the order of these tables
+    assert(sc_intmap_is_sorted(sc_special_keys, ARRAY_LEN(sc_special_keys)));
+    assert(sc_intmap_is_sorted(sc_kp_nav_keys, ARRAY_LEN(sc_kp_nav_keys)));
+    assert(sc_intmap_is_sorted(sc_alphaspace_keys,
+                               ARRAY_LEN(sc_alphaspace_keys)));
+    assert(sc_intmap_is_sorted(sc_numbers_punct_keys,
+                               ARRAY_LEN(sc_numbers_punct_keys)));
+}
+
+int main(int argc, char *argv[]) {
+    (void) argc;
+    (void) argv;
+
+    test_intmap_find_sorted();
+    test_intmap_find_sorted_empty();
+    test_intmap_is_sorted();
+    test_intmap_keyboard_inject_keys_sorted();
+
+    return 0;
+}
@@ -184,6 +184,37 @@ static void test_vecdeque_push_hole(void) {
     sc_vecdeque_destroy(&vdq);
 }
 
+static void test_vecdeque_getref(void) {
+    struct SC_VECDEQUE(int) vdq = SC_VECDEQUE_INITIALIZER;
+
+    bool ok = sc_vecdeque_reserve(&vdq, 4);
+    assert(ok);
+
+    // make the content wrap around the end of the internal array
+    for (int i = 0; i < 3; ++i) {
+        sc_vecdeque_push_noresize(&vdq, i);
+    }
+    (void) sc_vecdeque_pop(&vdq);
+    (void) sc_vecdeque_pop(&vdq);
+    for (int i = 3; i < 6; ++i) {
+        sc_vecdeque_push_noresize(&vdq, i);
+    }
+    assert(sc_vecdeque_size(&vdq) == 4);
+
+    for (size_t i = 0; i < 4; ++i) {
+        assert(*sc_vecdeque_getref(&vdq, i) == (int) i + 2);
+    }
+
+    // modify in place
+    *sc_vecdeque_getref(&vdq, 3) = 42;
+    assert(sc_vecdeque_pop(&vdq) == 2);
+    assert(sc_vecdeque_pop(&vdq) == 3);
+    assert(sc_vecdeque_pop(&vdq) == 4);
+    assert(sc_vecdeque_pop(&vdq) == 42);
+
+    sc_vecdeque_destroy(&vdq);
+}
+
 int main(int argc, char *argv[]) {
     (void) argc;
     (void) argv;
@@ -192,6 +223,7 @@ int main(int argc, char *argv[]) {
     test_vecdeque_reserve();
     test_vecdeque_grow();
     test_vecdeque_push_hole();
+    test_vecdeque_getref();
 
     return 0;
 }